@@ -26,11 +26,19 @@
 
 #include <qdltargument.h>
 #include <qdltmsg.h>
+#include <qdltmsgview.h>
+#include <qdltstringcache.h>
+#include <qdlttimeformatter.h>
 #include <qdltfilter.h>
+#include <qdltpatternmatcher.h>
+#include <qdltfilterplan.h>
 #include <qdltfilterlist.h>
 #include <qdltfilterindex.h>
 #include <qdltdefaultfilter.h>
+#include <qdltindex.h>
+#include <qdltmsgtable.h>
 #include <qdltfile.h>
+#include <qdltindexscanner.h>
 #include <qdltcontrol.h>
 #include <qdltconnection.h>
 #include <qdltipconnection.h>
@@ -65,11 +65,19 @@ SOURCES +=  \
     qdltmsg.cpp \
     qdltfilter.cpp \
     qdltfile.cpp \
+    qdltindexscanner.cpp \
+    qdltindex.cpp \
+    qdltmsgview.cpp \
+    qdltstringcache.cpp \
+    qdlttimeformatter.cpp \
+    qdltmsgtable.cpp \
     qdltcontrol.cpp \
     qdltconnection.cpp \
     qdltbase.cpp \
     qdltargument.cpp \
     qdltfilterlist.cpp \
+    qdltfilterplan.cpp \
+    qdltpatternmatcher.cpp \
     qdltfilterindex.cpp \
     qdltdefaultfilter.cpp \
     qdltpluginmanager.cpp \
@@ -90,11 +98,19 @@ HEADERS += qdlt.h \
     qdltmsg.h \
     qdltfilter.h \
     qdltfile.h \
+    qdltindexscanner.h \
+    qdltindex.h \
+    qdltmsgview.h \
+    qdltstringcache.h \
+    qdlttimeformatter.h \
+    qdltmsgtable.h \
     qdltcontrol.h \
     qdltconnection.h \
     qdltbase.h \
     qdltargument.h \
     qdltfilterlist.h \
+    qdltfilterplan.h \
+    qdltpatternmatcher.h \
     qdltfilterindex.h \
     qdltdefaultfilter.h \
     plugininterface.h \
@@ -20,6 +20,7 @@
  */
 
 #include <QtDebug>
+#include <string.h>
 
 #include "qdlt.h"
 
@@ -288,6 +289,104 @@ bool QDltArgument::setArgument(QByteArray &payload,unsigned int &offset,DltEndia
     return true;
 }
 
+/* read a length field of an argument */
+static unsigned short readArgumentLength(const char *data, QDltArgument::DltEndiannessDef endianness)
+{
+    unsigned short value;
+
+    memcpy(&value, data, sizeof(value));
+
+    return endianness == QDltArgument::DltEndiannessLittleEndian ? value : DLT_SWAP_16(value);
+}
+
+bool QDltArgument::checkArguments(const char *payload, unsigned int size, int count, DltEndiannessDef _endianess)
+{
+    unsigned int offset = 0;
+
+    for(int num = 0; num < count; num++)
+    {
+        unsigned int type;
+        unsigned short length = 0, length2 = 0, length3 = 0;
+
+        /* get type info */
+        if(size < offset + sizeof(unsigned int))
+            return false;
+        memcpy(&type, payload + offset, sizeof(type));
+        if(_endianess != DltEndiannessLittleEndian)
+            type = DLT_SWAP_32(type);
+        offset += sizeof(unsigned int);
+
+        /* same order of the type bits as in setArgument() */
+        bool isString = false, isBool = false, isNumber = false;
+        if(type & DLT_TYPE_INFO_STRG)
+            isString = true;
+        else if(type & DLT_TYPE_INFO_BOOL)
+            isBool = true;
+        else if(type & (DLT_TYPE_INFO_SINT | DLT_TYPE_INFO_UINT | DLT_TYPE_INFO_FLOA))
+            isNumber = true;
+        else if(type & (DLT_TYPE_INFO_RAWD | DLT_TYPE_INFO_TRAI))
+            isString = true;
+        else
+            return false;
+
+        /* get length of string, raw data or trace info */
+        if(isString)
+        {
+            if(size < offset + sizeof(unsigned short))
+                return false;
+            length = readArgumentLength(payload + offset, _endianess);
+            offset += sizeof(unsigned short);
+        }
+
+        /* skip variable info */
+        if(type & DLT_TYPE_INFO_VARI)
+        {
+            if(size < offset + sizeof(unsigned short))
+                return false;
+            length2 = readArgumentLength(payload + offset, _endianess);
+            offset += sizeof(unsigned short);
+            if(isNumber)
+            {
+                if(size < offset + sizeof(unsigned short))
+                    return false;
+                length3 = readArgumentLength(payload + offset, _endianess);
+                offset += sizeof(unsigned short);
+            }
+            offset += length2 + length3;
+        }
+
+        /* fix point quantisation is not supported */
+        if(type & DLT_TYPE_INFO_FIXP)
+            return false;
+
+        /* skip data */
+        if(isString)
+        {
+            if(size < offset + length)
+                return false;
+            offset += length;
+        }
+        else if(isBool)
+        {
+            offset += 1;
+        }
+        else
+        {
+            switch(type & DLT_TYPE_INFO_TYLE)
+            {
+                case DLT_TYLE_8BIT: offset += 1; break;
+                case DLT_TYLE_16BIT: offset += 2; break;
+                case DLT_TYLE_32BIT: offset += 4; break;
+                case DLT_TYLE_64BIT: offset += 8; break;
+                case DLT_TYLE_128BIT: offset += 16; break;
+                default: return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 bool QDltArgument::getArgument(QByteArray &payload, bool verboseMode) const
 {
     unsigned int dltType = 0;
@@ -530,6 +629,111 @@ QString QDltArgument::toString(bool binary) const
     return text;
 }
 
+/* read an integer of 1, 2, 4 or 8 bytes in the given endianness */
+static bool readInteger(const QByteArray &data, QDlt::DltEndiannessDef endianness, quint64 &value)
+{
+    switch(data.size())
+    {
+    case 1:
+        value = (unsigned char) data.constData()[0];
+        return true;
+    case 2:
+    {
+        unsigned short tmp;
+        memcpy(&tmp, data.constData(), sizeof(tmp));
+        value = (endianness == QDlt::DltEndiannessLittleEndian) ? tmp : (unsigned short) DLT_SWAP_16(tmp);
+        return true;
+    }
+    case 4:
+    {
+        unsigned int tmp;
+        memcpy(&tmp, data.constData(), sizeof(tmp));
+        value = (endianness == QDlt::DltEndiannessLittleEndian) ? tmp : (unsigned int) DLT_SWAP_32(tmp);
+        return true;
+    }
+    case 8:
+    {
+        quint64 tmp;
+        memcpy(&tmp, data.constData(), sizeof(tmp));
+        value = (endianness == QDlt::DltEndiannessLittleEndian) ? tmp : (quint64) DLT_SWAP_64(tmp);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+qint64 QDltArgument::toInt64(bool *ok) const
+{
+    quint64 value = 0;
+    bool valid = false;
+
+    if(typeInfo == DltTypeInfoSInt || typeInfo == DltTypeInfoUInt || typeInfo == DltTypeInfoBool)
+        valid = readInteger(data, endianness, value);
+
+    if(ok)
+        *ok = valid;
+    if(!valid)
+        return 0;
+
+    /* extend the sign of smaller signed integers */
+    if(typeInfo == DltTypeInfoSInt)
+    {
+        switch(data.size())
+        {
+        case 1: return (qint8) value;
+        case 2: return (qint16) value;
+        case 4: return (qint32) value;
+        default: break;
+        }
+    }
+
+    return (qint64) value;
+}
+
+quint64 QDltArgument::toUInt64(bool *ok) const
+{
+    return (quint64) toInt64(ok);
+}
+
+double QDltArgument::toDouble(bool *ok) const
+{
+    if(typeInfo == DltTypeInfoFloa)
+    {
+        quint64 value = 0;
+        bool valid = (data.size() == 4 || data.size() == 8) && readInteger(data, endianness, value);
+        if(ok)
+            *ok = valid;
+        if(!valid)
+            return 0;
+
+        if(data.size() == 4)
+        {
+            quint32 bits = (quint32) value;
+            float result;
+            memcpy(&result, &bits, sizeof(result));
+            return result;
+        }
+
+        double result;
+        memcpy(&result, &value, sizeof(result));
+        return result;
+    }
+
+    qint64 value = toInt64(ok);
+
+    /* large unsigned values must not become negative */
+    if(typeInfo == DltTypeInfoUInt)
+        return (double) (quint64) value;
+
+    return (double) value;
+}
+
+bool QDltArgument::toBool(bool *ok) const
+{
+    return toInt64(ok) != 0;
+}
+
 QVariant QDltArgument::getValue() const
 {
     switch(typeInfo) {
@@ -165,6 +165,17 @@ public:
     */
     bool setArgument(QByteArray &payload,unsigned int &offset,DltEndiannessDef _endianess);
 
+    //! Check if the arguments of a payload can be parsed, without extracting them.
+    /*!
+      Fails on the same errors as setArgument() called for each argument.
+      \param payload The payload of the DLT message.
+      \param size The size of the payload.
+      \param count The number of arguments.
+      \param _endianess The endianness of the arguments
+      \return true if all arguments can be parsed, false if there was an error.
+    */
+    static bool checkArguments(const char *payload, unsigned int size, int count, DltEndiannessDef _endianess);
+
     //! Get argument as byte array and appends it to data.
     /*!
       \param data byte array to be appended
@@ -185,6 +196,36 @@ public:
 
     QVariant getValue() const;
 
+    //! Get the value of an integer or bool argument without converting it to a QVariant.
+    /*!
+      \param ok Set to true if the argument is an integer or bool, else false.
+      \return The value, 0 if the argument is no integer or bool.
+    */
+    qint64 toInt64(bool *ok = 0) const;
+
+    //! Get the value of an unsigned integer or bool argument without converting it to a QVariant.
+    /*!
+      Signed integers are converted to unsigned.
+      \param ok Set to true if the argument is an integer or bool, else false.
+      \return The value, 0 if the argument is no integer or bool.
+    */
+    quint64 toUInt64(bool *ok = 0) const;
+
+    //! Get the value of a float or integer argument without converting it to a QVariant.
+    /*!
+      \param ok Set to true if the argument is a float, integer or bool, else false.
+      \return The value, 0 if the argument is no number.
+    */
+    double toDouble(bool *ok = 0) const;
+
+    //! Get the value of a bool argument without converting it to a QVariant.
+    /*!
+      Integer arguments are true, if they are not zero.
+      \param ok Set to true if the argument is a bool or integer, else false.
+      \return The value, false if the argument is no bool or integer.
+    */
+    bool toBool(bool *ok = 0) const;
+
     bool setValue(QVariant value, bool verboseMode = true);
 
 protected:
@@ -21,6 +21,11 @@
 
 #include <QFile>
 #include <QtDebug>
+#include <QMutexLocker>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#endif
 
 #include "qdlt.h"
 
@@ -29,6 +34,119 @@ extern "C"
 #include "dlt_common.h"
 }
 
+/* the mapping is only renewed, if the file has grown at least by this size or doubled its size */
+#define QDLT_FILE_REMAP_MIN_SIZE (16*1024*1024)
+
+QDltFileItem::QDltFileItem()
+{
+    indexedSize = 0;
+    mapFailed = false;
+    accessPattern = AccessRandom;
+}
+
+QDltFileItem::~QDltFileItem()
+{
+    unmap();
+}
+
+bool QDltFileItem::map()
+{
+    Mapping *current = mapping.loadAcquire();
+    qint64 size = infile.size();
+
+    if(mapFailed || !infile.isOpen() || size <= 0)
+        return current != 0;
+
+    /* remapping a growing file every time would waste address space */
+    if(current && size - current->size < qMax(current->size, (qint64) QDLT_FILE_REMAP_MIN_SIZE))
+        return true;
+
+    uchar *data = infile.map(0, size);
+    if(!data)
+    {
+        qDebug() << "Mapping of file" << infile.fileName() << "failed, reading with file access" << infile.errorString();
+        mapFailed = true;
+        return current != 0;
+    }
+
+    Mapping *next = new Mapping;
+    next->data = (const char *) data;
+    next->size = size;
+    mappings.append(next);
+
+    /* readers still using the previous mapping are not affected */
+    mapping.storeRelease(next);
+    advise(accessPattern);
+
+    return true;
+}
+
+void QDltFileItem::unmap()
+{
+    mapping.storeRelease(0);
+    for(int num = 0; num < mappings.size(); num++)
+    {
+        if(infile.isOpen())
+            infile.unmap((uchar *) mappings[num]->data);
+        delete mappings[num];
+    }
+    mappings.clear();
+    mapFailed = false;
+}
+
+const char *QDltFileItem::mappedData(qint64 pos, qint64 size) const
+{
+    Mapping *current = mapping.loadAcquire();
+
+    if(!current || pos < 0 || size < 0 || pos + size > current->size)
+        return 0;
+
+    return current->data + pos;
+}
+
+void QDltFileItem::updateTable()
+{
+    qint64 fileSize = infile.size();
+
+    if(table.size() > indexAll.size())
+        table.resize(indexAll.size());
+
+    for(int num = table.size(); num < indexAll.size(); num++)
+    {
+        qint64 pos = indexAll.at(num);
+        qint64 size = qMin(fileSize - pos, (qint64) QDLT_MSG_TABLE_MAX_MSG_SIZE);
+
+        const char *data = mappedData(pos, size);
+        if(data)
+        {
+            table.append(data, size);
+        }
+        else
+        {
+            /* data appended after the last mapping */
+            QByteArray buf;
+            if(infile.seek(pos))
+                buf = QDltMsgTable::readRowData(infile);
+            table.append(buf.constData(), buf.size());
+        }
+    }
+}
+
+void QDltFileItem::advise(AccessPattern pattern)
+{
+    accessPattern = pattern;
+
+#ifdef Q_OS_UNIX
+    Mapping *current = mapping.loadAcquire();
+    if(current)
+    {
+        /* mappings start at file position 0, so they are always page aligned */
+        if(madvise((void *) current->data, current->size, pattern == AccessSequential ? MADV_SEQUENTIAL : MADV_RANDOM) != 0)
+            qDebug() << "madvise failed for file" << infile.fileName();
+    }
+#endif
+}
+
 QDltFile::QDltFile()
 {
     filterFlag = false;
@@ -45,12 +163,15 @@ void QDltFile::clear()
 {
     for(int num=0;num<files.size();num++)
     {
+        files[num]->unmap();
         if(files[num]->infile.isOpen()) {
              files[num]->infile.close();
         }
         delete(files[num]);
     }
     files.clear();
+    stringCache.clear();
+    clearMsgMarks();
 }
 
 int QDltFile::getNumberOfFiles() const
@@ -58,14 +179,40 @@ int QDltFile::getNumberOfFiles() const
     return files.size();
 }
 
-void QDltFile::setDltIndex(QVector<qint64> &_indexAll, int num)
+void QDltFile::setDltIndex(const QDltIndex &_indexAll, int num, qint64 _indexedSize)
 {
     if(num<0 || num>=files.size())
     {
         return;
     }
 
+    mutexQDlt.lock();
     files[num]->indexAll = _indexAll;
+    files[num]->indexedSize = _indexedSize >= 0 ? _indexedSize : files[num]->infile.size();
+    files[num]->map();
+    mutexQDlt.unlock();
+}
+
+void QDltFile::setMsgTable(const QDltMsgTable &_table, int num)
+{
+    if(num<0 || num>=files.size())
+    {
+        return;
+    }
+
+    files[num]->table = _table;
+}
+
+const QDltMsgTable &QDltFile::getMsgTable(int num) const
+{
+    static const QDltMsgTable empty;
+
+    if(num<0 || num>=files.size())
+    {
+        return empty;
+    }
+
+    return files[num]->table;
 }
 
 int QDltFile::size() const
@@ -93,6 +240,21 @@ qint64 QDltFile::fileSize() const
     return size;
 }
 
+qint64 QDltFile::indexedSize() const
+{
+    qint64 size=0;
+
+    mutexQDlt.lock();
+    for(int num=0;num<files.size();num++)
+    {
+      if (nullptr!=files[num])
+         size += files[num]->indexedSize;
+    }
+    mutexQDlt.unlock();
+
+    return size;
+}
+
 int QDltFile::sizeFilter() const
 {
     if(filterFlag)
@@ -124,15 +286,23 @@ bool QDltFile::open(QString _filename, bool append)
         return false;
     }
 
+    /* messages are read lock free from the mapped file, if possible */
+    item->map();
+
     return true;
 }
 
 void QDltFile::clearIndex()
 {
+    mutexQDlt.lock();
     for(int num=0;num<files.size();num++)
     {
         files[num]->indexAll.clear();
+        files[num]->indexedSize = 0;
+        files[num]->table.clear();
     }
+    mutexQDlt.unlock();
+    stringCache.clear();
 }
 
 bool QDltFile::createIndex()
@@ -176,8 +346,7 @@ bool QDltFile::updateIndex()
         if(files[numFile]->indexAll.size())
         {
             /* move behind last found position */
-            const QVector<qint64>* const_indexAll = &(files[numFile]->indexAll);
-            pos = (*const_indexAll)[files[numFile]->indexAll.size()-1];
+            pos = files[numFile]->indexAll.last();
 
             // read the first 18 bytes of last message to look for actual size
             files[numFile]->infile.seek(pos + 18);
@@ -187,12 +356,13 @@ bool QDltFile::updateIndex()
             last_message_length = (unsigned char)buf.at(0);
             last_message_length = (last_message_length<<8 | ((unsigned char)buf.at(1))) +16;
 
-            // move just behind the next expected message
-            pos += (last_message_length - 1);
+            // move directly to the next expected message
+            pos += last_message_length;
             files[numFile]->infile.seek(pos);
         }
         else {
             /* the file was empty the last call */
+            pos = 0;
             files[numFile]->infile.seek(0);
         }
 
@@ -201,128 +371,46 @@ bool QDltFile::updateIndex()
 
         /* walk through the whole file and find all DLT0x01 markers */
         /* store the found positions in the indexAll */
-        char lastFound = 0;
-        qint64 current_message_pos = 0;
-        qint64 next_message_pos = 0;
-        int counter_header = 0;
-        quint16 message_length = 0;
-        qint64 file_size = files[numFile]->infile.size();
-        qint64 errors_in_file  = 0;
-
-        while(true)
+        /* data appended while scanning is indexed by the next call */
+        qint64 fileSize = files[numFile]->infile.size();
+        QDltIndexScanner scanner(fileSize, pos);
+        QDltIndex newIndex;
+
+        while(pos < fileSize)
         {
 
             /* read buffer from file */
-            buf = files[numFile]->infile.read(READ_BUF_SZ);
+            buf = files[numFile]->infile.read(qMin((qint64) READ_BUF_SZ, fileSize - pos));
             if(buf.isEmpty())
                 break; // EOF
 
-            /* Use primitive buffer for faster access */
-            int cbuf_sz = buf.size();
-            const char *cbuf = buf.constData();
-
-            /* find marker in buffer */
-            for(int num=0;num<cbuf_sz;num++) {
-                // search length of DLT message
-                if(counter_header>0)
-                {
-                    counter_header++;
-                    if (counter_header==16)
-                    {
-                        // Read low byte of message length
-                        message_length = (unsigned char)cbuf[num];
-                    }
-                    else if (counter_header==17)
-                    {
-                        // Read high byte of message length
-                        counter_header = 0;
-                        message_length = (message_length<<8 | ((unsigned char)cbuf[num])) +16;
-                        next_message_pos = current_message_pos + message_length;
-                        if(next_message_pos==file_size)
-                        {
-                            // last message found in file
-                            files[numFile]->indexAll.append(current_message_pos);
-                            break;
-                        }
-                        // speed up move directly to next message, if inside current buffer
-                        if((message_length > 20))
-                        {
-                            if((num+message_length-20<cbuf_sz))
-                            {
-                                num+=message_length-20;
-                            }
-                        }
-                    }
-                }
-                else if(cbuf[num] == 'D')
-                {
-                    lastFound = 'D';
-                }
-                else if(lastFound == 'D' && cbuf[num] == 'L')
-                {
-                    lastFound = 'L';
-                }
-                else if(lastFound == 'L' && cbuf[num] == 'T')
-                {
-                    lastFound = 'T';
-                }
-                else if(lastFound == 'T' && cbuf[num] == 0x01)
-                {
-                    if(next_message_pos == 0)
-                    {
-                        // first message detected or first message after error
-                        current_message_pos = pos+num-3;
-                        counter_header = 1;
-                        if(current_message_pos!=0)
-                        {
-                            // first messages not at beginning or error occured before
-                            errors_in_file++;
-                        }
-                        // speed up move directly to message length, if inside current buffer
-                        if(num+14<cbuf_sz)
-                        {
-                            num+=14;
-                            counter_header+=14;
-                        }
-                    }
-                    else if( next_message_pos == (pos+num-3) )
-                    {
-                        // Add message only when it is in the correct position in relationship to the last message
-                        files[numFile]->indexAll.append(current_message_pos);
-                        current_message_pos = pos+num-3;
-                        counter_header = 1;
-                        // speed up move directly to message length, if inside current buffer
-                        if(num+14<cbuf_sz)
-                        {
-                            num+=14;
-                            counter_header+=14;
-                        }
-                    }
-                    else if(next_message_pos > (pos+num-3))
-                    {
-                        // Header detected before end of message
-                    }
-                    else
-                    {
-                        // Header detected after end of message
-                        // start search for new message back after last header found
-                        files[numFile]->infile.seek(current_message_pos+4);
-                        pos = current_message_pos+4;
-                        buf = files[numFile]->infile.read(READ_BUF_SZ);
-                        cbuf_sz = buf.size();
-                        cbuf = buf.constData();
-                        num=0;
-                        next_message_pos = 0;
-                    }
-                    lastFound = 0;
-                }
-                else
-                {
-                    lastFound = 0;
-                }
+            QDltIndexScanner::ScanResult result = scanner.scan(buf.constData(), buf.size(), pos, newIndex);
+            if(result == QDltIndexScanner::ScanFinished)
+            {
+                // last message found in file
+                break;
+            }
+            else if(result == QDltIndexScanner::ScanResync)
+            {
+                // header detected after end of message
+                // start search for new message back after last header found
+                pos = scanner.getResyncPosition();
+                files[numFile]->infile.seek(pos);
+            }
+            else
+            {
+                pos += buf.size();
             }
-            pos += cbuf_sz;
         }
+
+        files[numFile]->indexAll.append(newIndex);
+        files[numFile]->indexedSize = fileSize;
+
+        /* map data appended to the file */
+        files[numFile]->map();
+
+        /* read the header fields of the new messages */
+        files[numFile]->updateTable();
     }
 
     mutexQDlt.unlock();
@@ -388,6 +476,7 @@ QDltFilterList QDltFile::getFilterList() const
 void QDltFile::setFilterList(QDltFilterList &_filterList)
 {
     filterList = _filterList;
+    clearMsgMarks();
 }
 
 void QDltFile::clearFilterIndex()
@@ -449,21 +538,20 @@ void QDltFile::close()
     clear();
 }
 
-QByteArray QDltFile::getMsg(int index) const
+bool QDltFile::getMsgPosition(int index, QDltFileItem *&file, qint64 &pos, qint64 &size) const
 {
-    QByteArray buf;
     int num = 0;
 
-
     /* check if index is in range */
     if( index < 0 )
     {
         qDebug() << "getMsg: Index is out of range" << __FILE__ << "line" << __LINE__;
-
-        /* return empty data buffer */
-        return QByteArray();
+        return false;
     }
 
+    /* the index is extended by updateIndex() while reading, only the mapped data is read without lock */
+    QMutexLocker locker(&mutexQDlt);
+
     for( num=0; num < files.size(); num++ )
     {
         if(index < files[num]->indexAll.size())
@@ -475,25 +563,59 @@ QByteArray QDltFile::getMsg(int index) const
     if(num >= files.size())
     {
      qDebug() << "getMsg: Index is out of range in" << __FILE__ << "line" << __LINE__;
-     /* return empty data buffer */
-     return QByteArray();
+     return false;
     }
 
     /* check if file is already opened */
     if(false == files[num]->infile.isOpen())
     {
-        /* return empty buffer */
         qDebug() << "getMsg: Infile is not open" << files[num]->infile.fileName() << __FILE__ << "line" << __LINE__;
+        return false;
+    }
+
+    file = files[num];
+    const QDltFileItem* const_file = file;
+    pos = const_file->indexAll[index];
+
+    if(index == (file->indexAll.size()-1))
+    {
+        /* last message in file */
+        size = file->infile.size() - pos;
+    }
+    else
+    {
+        /* any other file position */
+        size = const_file->indexAll[index+1] - pos;
+    }
+
+    if ( size < 0 )
+    {
+        qDebug() << "Negativ index " << size << index << "in" << file->infile.fileName() << __LINE__ << "of" << __FILE__;
+        return false;
+    }
+
+    return true;
+}
+
+QByteArray QDltFile::getMsg(int index) const
+{
+    QDltFileItem *file = 0;
+    qint64 positionForIndex = 0;
+    qint64 size = 0;
+    QByteArray buf;
 
+    if(!getMsgPosition(index, file, positionForIndex, size))
+    {
         /* return empty data buffer */
         return QByteArray();
     }
 
-    mutexQDlt.lock();
+    /* copy DLT message from mapped file without locking */
+    const char *data = file->mappedData(positionForIndex, size);
+    if(data)
+        return QByteArray(data, size);
 
-    QDltFileItem* file = files[num];
-    const QDltFileItem* const_file = file;
-    qint64 positionForIndex = const_file->indexAll[index];
+    mutexQDlt.lock();
 
     /* move to file position selected by index */
     if ( false == file->infile.seek(positionForIndex) )
@@ -505,25 +627,7 @@ QByteArray QDltFile::getMsg(int index) const
     }
 
     /* read DLT message from file */
-    if(index == (file->indexAll.size()-1))
-    {
-        /* last message in file */
-        long int cal_index = file->infile.size() - positionForIndex;
-
-        if ( cal_index < 0 )
-            qDebug() << "Negativ index " << cal_index << index << "in" << file->infile.fileName() << __LINE__ << "of" << __FILE__;
-        else
-         buf = file->infile.read(file->infile.size() - positionForIndex);
-    }
-    else
-    {
-        /* any other file position */
-        long int cal_index = const_file->indexAll[index+1] - positionForIndex;
-        if ( cal_index < 0 )
-            qDebug() << "Negativ index " << cal_index << index << "in" << __LINE__ << "of" << __FILE__;
-        else
-         buf = file->infile.read(cal_index);
-    }
+    buf = file->infile.read(size);
 
     mutexQDlt.unlock();
 
@@ -531,6 +635,33 @@ QByteArray QDltFile::getMsg(int index) const
     return buf;
 }
 
+QByteArray QDltFile::getMsgRaw(int index) const
+{
+    QDltFileItem *file = 0;
+    qint64 positionForIndex = 0;
+    qint64 size = 0;
+
+    if(!getMsgPosition(index, file, positionForIndex, size))
+        return QByteArray();
+
+    /* reference DLT message in mapped file */
+    const char *data = file->mappedData(positionForIndex, size);
+    if(data)
+        return QByteArray::fromRawData(data, size);
+
+    return getMsg(index);
+}
+
+void QDltFile::adviseAccess(QDltFileItem::AccessPattern pattern)
+{
+    mutexQDlt.lock();
+    for(int num=0;num<files.size();num++)
+    {
+        files[num]->advise(pattern);
+    }
+    mutexQDlt.unlock();
+}
+
 bool QDltFile::getMsg(int index,QDltMsg &msg) const
 {
     QByteArray data = getMsg(index);
@@ -596,6 +727,7 @@ int QDltFile::getMsgFilterPos(int index) const
 void QDltFile::clearFilter()
 {
     filterList.clearFilter();
+    clearMsgMarks();
 }
 
 void QDltFile::addFilter(QDltFilter *_filter)
@@ -606,6 +738,7 @@ void QDltFile::addFilter(QDltFilter *_filter)
 void QDltFile::updateSortedFilter()
 {
     filterList.updateSortedFilter();
+    clearMsgMarks();
 }
 
 bool QDltFile::isFilter() const
@@ -628,12 +761,85 @@ void QDltFile::enableSortByTimestamp(bool state)
     sortByTimestampFlag = state;
 }
 
-QVector<qint64> QDltFile::getIndexFilter() const
+const QDltIndex &QDltFile::getIndexFilter() const
 {
     return indexFilter;
 }
 
-void QDltFile::setIndexFilter(QVector<qint64> _indexFilter)
+void QDltFile::setIndexFilter(const QDltIndex &_indexFilter)
 {
     indexFilter = _indexFilter;
 }
+
+quint16 QDltFile::createMsgMark(const QDltMsg &msg, int marker)
+{
+    quint16 mark = DltMsgMarkValid;
+
+    /* markers behind the range of the mark are ignored */
+    if(marker >= 0 && marker < DltMsgMarkMarker)
+        mark |= (quint16) (marker + 1);
+
+    /* same conditions as the automatic marking of the views */
+    if(msg.getType() == QDltMsg::DltTypeLog &&
+       (msg.getSubtype() == QDltMsg::DltLogFatal || msg.getSubtype() == QDltMsg::DltLogError))
+        mark |= DltMsgMarkError;
+    if(msg.getType() == QDltMsg::DltTypeLog && msg.getSubtype() == QDltMsg::DltLogWarn)
+        mark |= DltMsgMarkWarn;
+    if(msg.getType() == QDltMsg::DltTypeControl && msg.getSubtype() == QDltMsg::DltControlResponse &&
+       msg.getCtrlServiceId() == DLT_SERVICE_ID_MARKER)
+        mark |= DltMsgMarkControl;
+
+    return mark;
+}
+
+quint16 QDltFile::checkMsgMark(QDltMsg &msg, int index) const
+{
+    /* the marker is stored also if filters are disabled, it is checked when the colour is needed */
+    quint16 mark = createMsgMark(msg, filterList.checkMarkerPosition(msg, &stringCache, index));
+
+    int count = size();
+    if(index >= 0 && index < count)
+    {
+        QMutexLocker locker(&mutexMsgMarks);
+        if(msgMarks.size() < count)
+            msgMarks.resize(count);
+        msgMarks[index] = mark;
+    }
+
+    return mark;
+}
+
+quint16 QDltFile::getMsgMark(int index) const
+{
+    QMutexLocker locker(&mutexMsgMarks);
+    if(index < 0 || index >= msgMarks.size())
+        return 0;
+
+    return msgMarks[index];
+}
+
+void QDltFile::setMsgMarks(const QVector<quint16> &marks)
+{
+    QMutexLocker locker(&mutexMsgMarks);
+    msgMarks = marks;
+}
+
+void QDltFile::clearMsgMarks()
+{
+    QMutexLocker locker(&mutexMsgMarks);
+    msgMarks.clear();
+}
+
+#ifdef USECOLOR
+QColor QDltFile::getMsgMarkColor(quint16 mark) const
+{
+    if(!filterFlag)
+        return QColor();
+
+    const QDltFilter *marker = filterList.getMarker((mark & DltMsgMarkMarker) - 1);
+    if(!marker)
+        return QColor();
+
+    return QColor(marker->filterColour);
+}
+#endif
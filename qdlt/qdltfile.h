@@ -31,11 +31,28 @@
 #include <QColor>
 #endif
 #include <QMutex>
+#include <QAtomicPointer>
 #include <time.h>
 
+//! One DLT log file with its index.
+/*!
+  The file is mapped into memory if possible, so messages can be read without
+  locking and without moving the file position. If mapping fails, messages are read
+  with infile as before. Data appended to the file after mapping is also read with infile,
+  until the mapping is updated with map().
+*/
 class QDLT_EXPORT QDltFileItem
 {
 public:
+    //! Expected access to the messages of the file, used as hint for the operating system.
+    typedef enum { AccessRandom = 0, AccessSequential } AccessPattern;
+
+    //! The constructor.
+    QDltFileItem();
+
+    //! The destructor.
+    ~QDltFileItem();
+
     //! DLT log file.
     QFile infile;
 
@@ -43,8 +60,71 @@ public:
     /*!
       Index contains positions of beginning of DLT messages in DLT log file.
     */
-    QVector<qint64> indexAll;
+    QDltIndex indexAll;
+
+    //! Size of the DLT log file, which was scanned for indexAll.
+    /*!
+      Smaller than the file size, if the file has grown since it was indexed.
+    */
+    qint64 indexedSize;
+
+    //! Header fields of all DLT messages.
+    /*!
+      Contains one row per message of indexAll, if the table is complete.
+    */
+    QDltMsgTable table;
+
+    //! Append the header fields of all messages of indexAll, which are not in the table yet.
+    /*!
+      The headers are read from the mapped file or with infile, must be called with the file locked.
+    */
+    void updateTable();
+
+    //! Map the opened file into memory or update the mapping if the file has grown.
+    /*!
+      Previous mappings stay valid until unmap() is called, so readers never need a lock.
+      Must not be called concurrently with itself or unmap().
+      \return true if the file is mapped, false if the file must be read with infile.
+    */
+    bool map();
+
+    //! Remove all mappings of the file.
+    void unmap();
 
+    //! Get the mapped data of a part of the file.
+    /*!
+      This function is thread safe and does not lock.
+      \param pos The file position.
+      \param size The number of bytes.
+      \return pointer to the data, NULL if this part of the file is not mapped.
+    */
+    const char *mappedData(qint64 pos, qint64 size) const;
+
+    //! Give a hint to the operating system how the mapped file is accessed.
+    /*!
+      \param pattern The expected access pattern.
+    */
+    void advise(AccessPattern pattern);
+
+private:
+    //! One mapping of the file.
+    struct Mapping
+    {
+        const char *data;
+        qint64 size;
+    };
+
+    //! The latest and largest mapping, used by readers.
+    QAtomicPointer<Mapping> mapping;
+
+    //! All mappings created since the file was opened.
+    QList<Mapping*> mappings;
+
+    //! Mapping failed, file is read with infile only.
+    bool mapFailed;
+
+    //! Access pattern applied to new mappings.
+    AccessPattern accessPattern;
 };
 
 //! Access to a DLT log file.
@@ -55,6 +135,10 @@ public:
 class QDLT_EXPORT QDltFile : public QDlt
 {
 public:
+    //! Parts of the mark of a message, see getMsgMark().
+    typedef enum { DltMsgMarkMarker = 0x0fff, DltMsgMarkError = 0x1000, DltMsgMarkWarn = 0x2000,
+                   DltMsgMarkControl = 0x4000, DltMsgMarkValid = 0x8000 } DltMsgMark;
+
     //! The constructor.
     /*!
     */
@@ -82,6 +166,12 @@ public:
     */
     qint64 fileSize() const;
 
+    //! Get the size of the DLT log files, which was scanned for the index.
+    /*!
+      \return the sum of the indexed sizes of all files, smaller than fileSize() if the files have grown since.
+    */
+    qint64 indexedSize() const;
+
     //! Get the number of filtered DLT message in the DLT log file.
     /*!
       \return the number of filtered DLT messages in the currently opened DLT file.
@@ -103,9 +193,27 @@ public:
 
     //! Sets the internal index of all DLT messages.
     /*!
+      The index is shared, not copied.
       \param New index list of all DLT messages
+      \param _indexedSize Size of the file scanned for the index, -1 for the current file size
+    */
+    void setDltIndex(const QDltIndex &_indexAll, int num = 0, qint64 _indexedSize = -1);
+
+    //! Sets the header fields of all DLT messages.
+    /*!
+      The table is shared, not copied.
+      \param _table New table with one row per message of the index
+    */
+    void setMsgTable(const QDltMsgTable &_table, int num = 0);
+
+    //! Get the header fields of all DLT messages of a file.
+    /*!
+      The rows are only valid, if the table has the same size as the index of the file,
+      see getFileMsgNumber().
+      \param num The number of the file.
+      \return the table, an empty table if the file does not exist.
     */
-    void setDltIndex(QVector<qint64> &_indexAll, int num = 0);
+    const QDltMsgTable &getMsgTable(int num = 0) const;
 
     //! Clears the internal index of all DLT messages.
     /*!
@@ -152,6 +260,23 @@ public:
     */
     QByteArray getMsg(int index) const;
 
+    //! Get one DLT message of the DLT log file selected by index without copying it.
+    /*!
+      If the file is memory mapped, the returned byte array references the mapped file directly,
+      it is only valid until the file is closed and must be copied, if it is kept longer.
+      Otherwise the message is read from the file like in getMsg().
+      \param index position of the DLT message in the log file up to the number DLT messages in the file
+      \return Byte array containing the complete DLT message.
+    */
+    QByteArray getMsgRaw(int index) const;
+
+    //! Give a hint to the operating system how the DLT log files are accessed.
+    /*!
+      Use AccessSequential while all messages are read in file order, e.g. during filtering.
+      \param pattern The expected access pattern.
+    */
+    void adviseAccess(QDltFileItem::AccessPattern pattern);
+
     //! Get one DLT message of the filtered DLT log file selected by index
     /*!
       \param index position of the DLT message in the log file up to the number of DLT messages in the file
@@ -271,17 +396,77 @@ public:
     /*!
      * \return List of file positions
      **/
-    QVector<qint64> getIndexFilter() const;
+    const QDltIndex &getIndexFilter() const;
 
     //! Set Index of all DLT messages matching filter
     /*!
+     * The index is shared, not copied.
      * \param _indexFilter List of file positions
      **/
-    void setIndexFilter(QVector<qint64> _indexFilter);
+    void setIndexFilter(const QDltIndex &_indexFilter);
+
+    //! Get the cache of rendered header and payload strings of the messages.
+    /*!
+      The strings are cached by the index of the message, the cache is cleared when the index is cleared.
+      \return The cache, which can be used from several threads.
+    */
+    QDltStringCache *getStringCache() const { return &stringCache; }
+
+    //! Create the mark of a message.
+    /*!
+      The mark contains the first matching marker and the log levels and control messages,
+      which can be marked automatically. It is stored in two bytes, so painting a message
+      does not need to check the markers again.
+      \param msg The parsed and decoded message.
+      \param marker The position of the first matching marker, see QDltFilterList::checkMarkerPosition(), -1 if none.
+      \return The mark, the marker position plus one is stored in DltMsgMarkMarker.
+    */
+    static quint16 createMsgMark(const QDltMsg &msg, int marker);
+
+    //! Check the markers of a message and store its mark.
+    /*!
+      \param msg The parsed and decoded message.
+      \param index The index of the message in the log file.
+      \return The mark, see createMsgMark().
+    */
+    quint16 checkMsgMark(QDltMsg &msg, int index) const;
+
+    //! Get the stored mark of a message.
+    /*!
+      The marks are kept until the filters or markers are changed.
+      \param index The index of the message in the log file.
+      \return The mark, 0 if the mark of the message is not known yet.
+    */
+    quint16 getMsgMark(int index) const;
+
+    //! Set the marks of the messages, created while the file was filtered.
+    /*!
+      Called by the indexer thread, the marks are replaced under a mutex.
+      \param marks The mark of each message by index, 0 for messages not marked yet.
+    */
+    void setMsgMarks(const QVector<quint16> &marks);
+
+    //! Remove all stored marks, e.g. when the decoder plugins are changed.
+    void clearMsgMarks();
+
+#ifdef USECOLOR
+    //! Get the colour of the marker of a mark.
+    /*!
+      \param mark The mark of a message.
+      \return The colour of the marker, invalid if no marker matches or filters are disabled.
+    */
+    QColor getMsgMarkColor(quint16 mark) const;
+#endif
 
 protected:
 
 private:
+    //! Find the file and file position of a DLT message.
+    /*!
+      The index is read under mutexQDlt, as it is extended by updateIndex().
+    */
+    bool getMsgPosition(int index, QDltFileItem *&file, qint64 &pos, qint64 &size) const;
+
     //! Mutex to lock critical path for infile
     mutable QMutex mutexQDlt;
 
@@ -292,11 +477,24 @@ private:
     /*!
       Index contains positions of DLT messages in indexAll.
     */
-    QVector<qint64> indexFilter;
+    QDltIndex indexFilter;
 
     //! This contains the list of filters.
     QDltFilterList filterList;
 
+    //! Rendered strings of the messages.
+    mutable QDltStringCache stringCache;
+
+    //! Mark of each message, see getMsgMark().
+    /*!
+      The marks are set by the indexer thread and read and extended by the GUI thread,
+      all accesses are locked by mutexMsgMarks.
+    */
+    mutable QVector<quint16> msgMarks;
+
+    //! Mutex to lock the marks of the messages
+    mutable QMutex mutexMsgMarks;
+
     //! Enabling filter.
     /*!
       true filtering is enabled.
@@ -20,6 +20,7 @@
  */
 
 #include <QtDebug>
+#include <QCryptographicHash>
 
 #include "qdlt.h"
 
@@ -161,6 +162,11 @@ bool QDltFilter::compileRegexps()
 }
 
 bool QDltFilter::match(QDltMsg &msg) const
+{
+    return match(msg, 0, -1);
+}
+
+bool QDltFilter::match(QDltMsg &msg, QDltStringCache *cache, qint64 index) const
 {
 
     if( (true == enableEcuid) && (msg.getEcuid() != ecuid))
@@ -201,14 +207,14 @@ bool QDltFilter::match(QDltMsg &msg) const
 
     if(true == enableRegexp_Header)
     {
-        if( (true == enableHeader) && ( false == headerRegularExpression.match(msg.toStringHeader()).hasMatch() ) )
+        if( (true == enableHeader) && ( false == headerRegularExpression.match(cache ? cache->header(index, msg) : msg.toStringHeader()).hasMatch() ) )
         {
             return false;
         }
     }
     else
     {
-        if( ( true == enableHeader ) && ( false == msg.toStringHeader().contains(header,ignoreCase_Header?Qt::CaseInsensitive:Qt::CaseSensitive)) )
+        if( ( true == enableHeader ) && ( false == (cache ? cache->header(index, msg) : msg.toStringHeader()).contains(header,ignoreCase_Header?Qt::CaseInsensitive:Qt::CaseSensitive)) )
         {
             return false;
         }
@@ -216,14 +222,14 @@ bool QDltFilter::match(QDltMsg &msg) const
 
     if( true == enableRegexp_Payload)
     {
-        if( (true == enablePayload) && ( false == payloadRegularExpression.match(msg.toStringPayload()).hasMatch() ) )
+        if( (true == enablePayload) && ( false == payloadRegularExpression.match(cache ? cache->payload(index, msg) : msg.toStringPayload()).hasMatch() ) )
         {
             return false;
         }
     }
     else
     {
-        if( (true == enablePayload) && ( false == msg.toStringPayload().contains(payload,ignoreCase_Payload?Qt::CaseInsensitive:Qt::CaseSensitive)) )
+        if( (true == enablePayload) && ( false == (cache ? cache->payload(index, msg) : msg.toStringPayload()).contains(payload,ignoreCase_Payload?Qt::CaseInsensitive:Qt::CaseSensitive)) )
         {
             return false;
         }
@@ -263,6 +269,119 @@ bool QDltFilter::match(QDltMsg &msg) const
     return true;
 }
 
+/* compare a 32 bit id of QDltMsgView with a filter id, without converting the id */
+static bool equalsId(quint32 id, const QString &text)
+{
+    char data[4];
+    int length = 0;
+
+    memcpy(data, &id, sizeof(data));
+    while(length < 4 && data[length] != 0)
+        length++;
+
+    if(text.size() != length)
+        return false;
+
+    for(int num = 0; num < length; num++)
+    {
+        if(text.at(num) != QLatin1Char(data[num]))
+            return false;
+    }
+
+    return true;
+}
+
+/* same as QString::contains() for a 32 bit id of QDltMsgView */
+static bool containsId(quint32 id, const QString &text)
+{
+    char data[4];
+    int length = 0;
+
+    memcpy(data, &id, sizeof(data));
+    while(length < 4 && data[length] != 0)
+        length++;
+
+    for(int pos = 0; pos + text.size() <= length; pos++)
+    {
+        int num = 0;
+        while(num < text.size() && text.at(num) == QLatin1Char(data[pos + num]))
+            num++;
+        if(num == text.size())
+            return true;
+    }
+
+    return false;
+}
+
+bool QDltFilter::isHeaderOnly() const
+{
+    return !enableHeader && !enablePayload;
+}
+
+bool QDltFilter::match(const QDltMsgView &msg) const
+{
+    /* same checks as match(QDltMsg&), header and payload text are not available */
+    if( (true == enableEcuid) && !equalsId(msg.getEcuid(), ecuid) )
+    {
+        return false;
+    }
+
+    if( true == enableApid )
+    {
+        if( true == enableRegexp_Appid )
+        {
+            if( false == appidRegularExpression.match(QDltMsgView::idToString(msg.getApid())).hasMatch() )
+                return false;
+        }
+        else if( !equalsId(msg.getApid(), apid) )
+        {
+            return false;
+        }
+    }
+
+    if( true == enableCtid )
+    {
+        if( true == enableRegexp_Context )
+        {
+            if( false == contextRegularExpression.match(QDltMsgView::idToString(msg.getCtid())).hasMatch() )
+                return false;
+        }
+        else if( !containsId(msg.getCtid(), ctid) )
+        {
+            return false;
+        }
+    }
+
+    if (true == enableMessageId)
+    {
+        unsigned int messageId = msg.getMessageId();
+        if (messageIdMax==0)
+        {
+            if( messageId != messageIdMin )
+                return false;
+        }
+        else if( false == ((messageId>=messageIdMin)&&(messageId<messageIdMax)) )
+        {
+            return false;
+        }
+    }
+
+    if(enableCtrlMsgs && !((msg.getType() == QDltMsg::DltTypeControl)))
+    {
+        return false;
+    }
+    if(enableLogLevelMax && !((msg.getType() == QDltMsg::DltTypeLog) && (msg.getSubtype() <= logLevelMax)))
+    {
+        return false;
+    }
+    if(enableLogLevelMin && !((msg.getType() == QDltMsg::DltTypeLog) && (msg.getSubtype() >= logLevelMin)))
+    {
+        return false;
+    }
+
+    return true;
+}
+
 void QDltFilter::LoadFilterItem(QXmlStreamReader &xml)
 {
     if(xml.name() == QString("type"))
@@ -407,6 +526,50 @@ void QDltFilter::LoadFilterItem(QXmlStreamReader &xml)
 
 }
 
+QByteArray QDltFilter::createMD5Match() const
+{
+    QByteArray data;
+    QXmlStreamWriter xml(&data);
+
+    /* only the parameters used by match(), name, type, enable state and colour are not included */
+    if(enableEcuid)
+        xml.writeTextElement("ecuid",ecuid);
+    if(enableApid)
+    {
+        xml.writeTextElement("applicationid",apid);
+        xml.writeTextElement("enableregexp_Appid",QString("%1").arg(enableRegexp_Appid));
+    }
+    if(enableCtid)
+    {
+        xml.writeTextElement("contextid",ctid);
+        xml.writeTextElement("enableregexp_Context",QString("%1").arg(enableRegexp_Context));
+    }
+    if(enableHeader)
+    {
+        xml.writeTextElement("headertext",header);
+        xml.writeTextElement("enableregexp_Header",QString("%1").arg(enableRegexp_Header));
+        xml.writeTextElement("ignoreCase_Header",QString("%1").arg(ignoreCase_Header));
+    }
+    if(enablePayload)
+    {
+        xml.writeTextElement("payloadtext",payload);
+        xml.writeTextElement("enableregexp_Payload",QString("%1").arg(enableRegexp_Payload));
+        xml.writeTextElement("ignoreCase_Payload",QString("%1").arg(ignoreCase_Payload));
+    }
+    if(enableMessageId)
+    {
+        xml.writeTextElement("messageIdMin",QString("%1").arg(messageIdMin));
+        xml.writeTextElement("messageIdMax",QString("%1").arg(messageIdMax));
+    }
+    xml.writeTextElement("enablectrlmsgs",QString("%1").arg(enableCtrlMsgs));
+    if(enableLogLevelMin)
+        xml.writeTextElement("logLevelMin",QString("%1").arg(logLevelMin));
+    if(enableLogLevelMax)
+        xml.writeTextElement("logLevelMax",QString("%1").arg(logLevelMax));
+
+    return QCryptographicHash::hash(data, QCryptographicHash::Md5);
+}
+
 void QDltFilter::SaveFilterItem(QXmlStreamWriter &xml)
 {
     xml.writeTextElement("type",QString("%1").arg((int)(type)));
@@ -131,6 +131,36 @@ public:
     */
     bool match(QDltMsg &msg) const;
 
+    //! Check if filter matches, using rendered strings of a cache.
+    /*!
+      \param msg The parsed and decoded message.
+      \param cache The cache of rendered strings, the strings are not cached if 0.
+      \param index The index of the message in the log file.
+      \return true if filter matches the message, else false
+    */
+    bool match(QDltMsg &msg, QDltStringCache *cache, qint64 index) const;
+
+    //! Check if filter matches the header of a message, which is not parsed.
+    /*!
+      Only valid if isHeaderOnly() is true, the result is the same as of match() for the parsed message.
+      \return true if filter matches the message, else false
+    */
+    bool match(const QDltMsgView &msg) const;
+
+    //! Check if the filter only needs the header fields of a message.
+    /*!
+      Header and payload text are not needed, the filter can be checked with a QDltMsgView.
+      \return true if the filter does not match the header or payload text
+    */
+    bool isHeaderOnly() const;
+
+    //! Create a MD5 checksum over all parameters, which change the result of match().
+    /*!
+      Filters with the same checksum match the same messages, independent of their name, type and enable state.
+      \return the MD5 checksum
+    */
+    QByteArray createMD5Match() const;
+
     //! Save filter parameters in XML file.
     /*!
     */
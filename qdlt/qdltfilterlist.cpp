@@ -72,6 +72,12 @@ void QDltFilterList::clearFilter()
         delete filter;
     }
     filters.clear();
+
+    /* the sorted lists and the plan point to the deleted filters */
+    mfilters.clear();
+    pfilters.clear();
+    nfilters.clear();
+    plan.clear();
     //qDebug() << "clearFilter: Clear filter";
 }
 
@@ -85,87 +91,53 @@ void QDltFilterList::addFilter(QDltFilter *_filter)
 #ifdef USECOLOR
 QColor QDltFilterList::checkMarker(QDltMsg &msg)
 {
-    QDltFilter *filter;
     QColor color;
 
-    for(int numfilter=0;numfilter<mfilters.size();numfilter++)
-    {
-        filter = mfilters[numfilter];
+    /* the plan checks only the markers, which can match the ids of the message */
+    const QDltFilter *filter = plan.checkMarker(msg, 0, -1);
+    if(filter)
+        color = filter->filterColour;
 
-        if(filter->match(msg))
-        {
-            color = filter->filterColour;
-            break;
-        }
-    }
     return color;
 }
 #else
 QString QDltFilterList::checkMarker(QDltMsg &msg)
 {
-    QDltFilter *filter;
     QString color=DEFAULT_COLOR;
 
-    for(int numfilter=0;numfilter<mfilters.size();numfilter++)
-    {
-        filter = mfilters[numfilter];
+    /* the plan checks only the markers, which can match the ids of the message */
+    const QDltFilter *filter = plan.checkMarker(msg, 0, -1);
+    if(filter)
+        color = filter->filterColour;
 
-        if(filter->match(msg))
-        {
-            color = filter->filterColour;
-            break;
-        }
-    }
     return color;
 }
 
 #endif
 
-bool QDltFilterList::checkFilter(QDltMsg &msg)
+int QDltFilterList::checkMarkerPosition(QDltMsg &msg, QDltStringCache *cache, qint64 index) const
 {
-    QDltFilter *filter;
-    bool found = false;
-    bool filterActivated = false;
-
-    /* If there are no positive filters, or all positive filters
-     * are disabled, the default case is to show all messages. Only
-     * negative filters will be applied */
-    if(pfilters.size())
-        filterActivated = true;
-
-    if(filterActivated==false)
-        found = true;
-    else
-        found = false;
-
+    /* the markers are compiled in the order of mfilters */
+    return plan.checkMarkerPosition(msg, cache, index);
+}
 
-    for(int numfilter=0;numfilter<pfilters.size();numfilter++)
-    {
-        filter = pfilters[numfilter];
-        found = filter->match(msg);
-        if (found)
-          break;
-    }
+const QDltFilter *QDltFilterList::getMarker(int position) const
+{
+    if(position < 0 || position >= mfilters.size())
+        return 0;
 
-    if (found || filterActivated==false ){
-        //we need only to check for negative filters, if the message would be shown! If discarded anyway, there is no need to apply it.
-        //if positive filter applied -> check for negative filters
-        //if no positive filters are active or no one exists, we need also to filter negatively
-        // if the message has been discarded by all positive filters before, we do not need to filter it away a second time
+    return mfilters[position];
+}
 
-        for(int numfilter=0;numfilter<nfilters.size();numfilter++)
-        {
-            filter = nfilters[numfilter];
-            if (filter->match(msg))
-            {
-                // a negative filter has matched -> found = false
-                found = false;
-                break;
-            }
-        }
-      }
+bool QDltFilterList::checkFilter(QDltMsg &msg)
+{
+    return checkFilter(msg, 0, -1);
+}
 
-    return found;
+bool QDltFilterList::checkFilter(QDltMsg &msg, QDltStringCache *cache, qint64 index)
+{
+    /* the positive and negative filters are checked with the compiled plan */
+    return plan.check(msg, cache, index);
 }
 
 bool QDltFilterList::SaveFilter(QString _filename)
@@ -288,6 +260,21 @@ bool QDltFilterList::LoadFilter(QString _filename, bool replace){
     return retVal;
 }
 
+bool QDltFilterList::checkFilter(const QDltMsgView &msg)
+{
+    return plan.check(msg);
+}
+
+bool QDltFilterList::checkFilter(const QDltMsgTable &table, int row)
+{
+    return plan.check(table, row);
+}
+
+bool QDltFilterList::isHeaderOnly() const
+{
+    return plan.isHeaderOnly();
+}
+
 void QDltFilterList::updateSortedFilter()
 {
     mfilters.clear();
@@ -319,4 +306,6 @@ void QDltFilterList::updateSortedFilter()
         }
     }
 
+    /* compile the filters, ids are compared as integers and exact ids are found in hash tables */
+    plan.compile(pfilters, nfilters, mfilters);
 }
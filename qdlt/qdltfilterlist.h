@@ -35,6 +35,8 @@
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 
+class QDltMsgTable;
+
 class QDLT_EXPORT QDltFilterList
 {
 public:
@@ -87,7 +89,21 @@ public:
     QString checkMarker(QDltMsg &msg);
 #endif
 
+    //! Get the position of the first enabled marker matching a message.
+    /*!
+      \param msg The parsed and decoded message
+      \param cache The cache of rendered strings, the strings are not cached if 0
+      \param index The index of the message in the log file
+      \return the position of the marker, see getMarker(), -1 if no marker matches
+    */
+    int checkMarkerPosition(QDltMsg &msg, QDltStringCache *cache, qint64 index) const;
 
+    //! Get an enabled marker by its position, see checkMarkerPosition().
+    /*!
+      \param position The position of the marker
+      \return the marker, 0 if the position is out of range
+    */
+    const QDltFilter *getMarker(int position) const;
 
     //! Check if message matches the filter.
     /*!
@@ -96,6 +112,39 @@ public:
     */
     bool checkFilter(QDltMsg &msg);
 
+    //! Check if message matches the filter, using rendered strings of a cache.
+    /*!
+      The header and payload strings are rendered only once for all filters.
+      \param msg The parsed and decoded message
+      \param cache The cache of rendered strings
+      \param index The index of the message in the log file
+      \return true if message will be displayed, false if message will be filtered out
+    */
+    bool checkFilter(QDltMsg &msg, QDltStringCache *cache, qint64 index);
+
+    //! Check if the header of a message matches the filter, without parsing the message.
+    /*!
+      Only valid if isHeaderOnly() is true.
+      \param msg The message to be checked
+      \return true if message will be displayed, false if message will be filtered out
+    */
+    bool checkFilter(const QDltMsgView &msg);
+
+    //! Check if a message matches the filter with the header fields of the message table.
+    /*!
+      Only valid if isHeaderOnly() is true.
+      \param table The header fields of the messages of a log file
+      \param row The row of the message in the table
+      \return true if message will be displayed, false if message will be filtered out
+    */
+    bool checkFilter(const QDltMsgTable &table, int row);
+
+    //! Check if all enabled filters only need the header fields of a message.
+    /*!
+      \return true if checkFilter() can be used with a QDltMsgView
+    */
+    bool isHeaderOnly() const;
+
     //! Save the filter.
     /*!
     */
@@ -118,6 +167,8 @@ public:
 
     //! Update the presorted list for performance improvement.
     /*!
+      The positive and negative filters and markers are compiled into an evaluation plan,
+      this must be called again when a filter is changed.
     */
     void updateSortedFilter();
 
@@ -136,6 +187,9 @@ private:
     //! List of nfilters.
     QList<QDltFilter*> nfilters;
 
+    //! Compiled plan of pfilters and nfilters, updated by updateSortedFilter().
+    QDltFilterPlan plan;
+
 };
 
 #endif // QDLT_FILTER_LIST_H
@@ -0,0 +1,572 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltfilterplan.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QtDebug>
+#include <algorithm>
+#include <limits.h>
+#include <string.h>
+
+#include "qdltfilterplan.h"
+#include "qdltfilter.h"
+#include "qdltmsg.h"
+#include "qdltmsgview.h"
+#include "qdltmsgtable.h"
+#include "qdltstringcache.h"
+
+/* convert an id to its 32 bit value, false if the id is longer than 4 characters or not ASCII */
+static bool idFromAscii(const QString &id, quint32 &value)
+{
+    char data[4] = {0, 0, 0, 0};
+
+    if(id.size() > 4)
+        return false;
+
+    for(int num = 0; num < id.size(); num++)
+    {
+        ushort c = id.at(num).unicode();
+        if(c == 0 || c >= 0x80)
+            return false;
+        data[num] = (char) c;
+    }
+    memcpy(&value, data, sizeof(value));
+
+    return true;
+}
+
+/* remove the bytes after the end of an id read from the message data, false if the id is not ASCII */
+static bool normalizeId(quint32 &value)
+{
+    char data[4];
+    bool ascii = true;
+
+    memcpy(data, &value, sizeof(data));
+    for(int num = 0; num < 4; num++)
+    {
+        if(data[num] == 0)
+        {
+            memset(data + num, 0, 4 - num);
+            break;
+        }
+        if((uchar) data[num] >= 0x80)
+            ascii = false;
+    }
+    memcpy(&value, data, sizeof(value));
+
+    return ascii;
+}
+
+/* same as QString::contains() for two 32 bit ids */
+static bool containsId(quint32 id, quint32 pattern, int patternLength)
+{
+    char data[4];
+    char text[4];
+    int length = 0;
+
+    memcpy(data, &id, sizeof(data));
+    memcpy(text, &pattern, sizeof(text));
+    while(length < 4 && data[length] != 0)
+        length++;
+
+    for(int pos = 0; pos + patternLength <= length; pos++)
+    {
+        if(memcmp(data + pos, text, patternLength) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+/* The values of one message, which are read once for all filters */
+class QDltFilterPlan::Context
+{
+public:
+    Context(const QDltFilterPlan &plan, QDltMsg &msg, QDltStringCache *cache, qint64 index)
+        : msg(&msg), view(0), cache(cache), index(index), plan(plan),
+          headerRendered(false), payloadRendered(false), headerScanned(false), payloadScanned(false)
+    {
+        ecuidAscii = idFromAscii(msg.getEcuid(), ecuid);
+        apidAscii = idFromAscii(msg.getApid(), apid);
+        ctidAscii = idFromAscii(msg.getCtid(), ctid);
+        type = msg.getType();
+        subtype = msg.getSubtype();
+        messageId = msg.getMessageId();
+    }
+
+    Context(const QDltFilterPlan &plan, const QDltMsgView &view)
+        : msg(0), view(&view), cache(0), index(-1), plan(plan),
+          headerRendered(false), payloadRendered(false), headerScanned(false), payloadScanned(false)
+    {
+        ecuid = view.getEcuid();
+        apid = view.getApid();
+        ctid = view.getCtid();
+        ecuidAscii = normalizeId(ecuid);
+        apidAscii = normalizeId(apid);
+        ctidAscii = normalizeId(ctid);
+        type = view.getType();
+        subtype = view.getSubtype();
+        messageId = view.getMessageId();
+    }
+
+    Context(const QDltFilterPlan &plan, const QDltMsgTable &table, int row)
+        : msg(0), view(0), cache(0), index(-1), plan(plan),
+          headerRendered(false), payloadRendered(false), headerScanned(false), payloadScanned(false)
+    {
+        ecuid = table.getEcuId(row);
+        apid = table.getApid(row);
+        ctid = table.getCtid(row);
+        ecuidAscii = normalizeId(ecuid);
+        apidAscii = normalizeId(apid);
+        ctidAscii = normalizeId(ctid);
+        type = table.getType(row);
+        subtype = table.getSubtype(row);
+        messageId = table.getMessageId(row);
+    }
+
+    /* without a parsed message the ids are the ids read from the header, up to the first 0 byte */
+    QString ecuidString() const { return msg ? msg->getEcuid() : QDltMsgView::idToString(ecuid); }
+    QString apidString() const { return msg ? msg->getApid() : QDltMsgView::idToString(apid); }
+    QString ctidString() const { return msg ? msg->getCtid() : QDltMsgView::idToString(ctid); }
+
+    const QString &headerText()
+    {
+        if(!headerRendered && msg)
+            header = cache ? cache->header(index, *msg) : msg->toStringHeader();
+        headerRendered = true;
+        return header;
+    }
+
+    const QString &payloadText()
+    {
+        if(!payloadRendered && msg)
+            payload = cache ? cache->payload(index, *msg) : msg->toStringPayload();
+        payloadRendered = true;
+        return payload;
+    }
+
+    /* all literal header texts of the filters are searched at once */
+    bool headerContains(int pattern)
+    {
+        if(!headerScanned)
+            plan.headerMatcher.match(headerText(), headerMatches);
+        headerScanned = true;
+        return headerMatches.testBit(pattern);
+    }
+
+    bool payloadContains(int pattern)
+    {
+        if(!payloadScanned)
+            plan.payloadMatcher.match(payloadText(), payloadMatches);
+        payloadScanned = true;
+        return payloadMatches.testBit(pattern);
+    }
+
+    QDltMsg *msg;
+    const QDltMsgView *view;
+    QDltStringCache *cache;
+    qint64 index;
+    const QDltFilterPlan &plan;
+
+    quint32 ecuid, apid, ctid;
+    bool ecuidAscii, apidAscii, ctidAscii;
+    int type;
+    int subtype;
+    unsigned int messageId;
+
+private:
+    QString header;
+    QString payload;
+    bool headerRendered;
+    bool payloadRendered;
+    QBitArray headerMatches;
+    QBitArray payloadMatches;
+    bool headerScanned;
+    bool payloadScanned;
+};
+
+QDltFilterPlan::Step::Step()
+    : filter(0), position(0), cost(0),
+      ecuidCheck(IdNone), apidCheck(IdNone), ctidCheck(IdNone), ecuid(0), apid(0), ctid(0), ctidLength(0),
+      checkMessageId(false), messageIdMin(0), messageIdMax(0),
+      checkControl(false), checkLogLevel(false), logLevelMin(0), logLevelMax(0),
+      headerCheck(TextNone), payloadCheck(TextNone), headerPattern(-1), payloadPattern(-1)
+{
+}
+
+QDltFilterPlan::QDltFilterPlan()
+    : headerOnly(true)
+{
+}
+
+void QDltFilterPlan::clear()
+{
+    positive.clear();
+    negative.clear();
+    markers.clear();
+    headerMatcher.clear();
+    payloadMatcher.clear();
+    headerOnly = true;
+}
+
+void QDltFilterPlan::compile(const QList<QDltFilter*> &positive, const QList<QDltFilter*> &negative,
+                             const QList<QDltFilter*> &markers)
+{
+    clear();
+
+    /* only one filter must match, so the order of positive and negative filters does not change the result */
+    this->positive.compile(positive, false, headerMatcher, payloadMatcher);
+    this->negative.compile(negative, false, headerMatcher, payloadMatcher);
+    this->markers.compile(markers, true, headerMatcher, payloadMatcher);
+    headerMatcher.build();
+    payloadMatcher.build();
+
+    for(int num = 0; num < positive.size(); num++)
+        headerOnly = headerOnly && positive[num]->isHeaderOnly();
+    for(int num = 0; num < negative.size(); num++)
+        headerOnly = headerOnly && negative[num]->isHeaderOnly();
+}
+
+void QDltFilterPlan::Group::clear()
+{
+    steps.clear();
+    apidCtidIndex.clear();
+    apidCtidByApid.clear();
+    apidIndex.clear();
+    ecuidIndex.clear();
+    residual.clear();
+}
+
+void QDltFilterPlan::Group::compile(const QList<QDltFilter*> &filters, bool keepOrder,
+                                    QDltPatternMatcher &headerMatcher, QDltPatternMatcher &payloadMatcher)
+{
+    clear();
+
+    for(int num = 0; num < filters.size(); num++)
+    {
+        steps.append(compileStep(filters[num], headerMatcher, payloadMatcher));
+        steps.last().position = num;
+    }
+
+    if(!keepOrder)
+        std::stable_sort(steps.begin(), steps.end(), [](const Step &a, const Step &b) { return a.cost < b.cost; });
+
+    /* a message can only match a filter with exact ids, if the message has the same ids,
+     * a context id with 4 characters is contained in a context id of the message with 4 characters only if both are the same */
+    for(int num = 0; num < steps.size(); num++)
+    {
+        const Step &step = steps.at(num);
+
+        if(step.apidCheck == IdEquals && step.ctidCheck == IdContains && step.ctidLength == 4)
+        {
+            apidCtidIndex[((quint64) step.apid << 32) | step.ctid].append(num);
+            apidCtidByApid[step.apid].append(num);
+        }
+        else if(step.apidCheck == IdEquals)
+            apidIndex[step.apid].append(num);
+        else if(step.ecuidCheck == IdEquals)
+            ecuidIndex[step.ecuid].append(num);
+        else
+            residual.append(num);
+    }
+}
+
+int QDltFilterPlan::Group::find(Context &context) const
+{
+    const QVector<int> *lists[4];
+    int pos[4] = {0, 0, 0, 0};
+    int count = 0;
+
+    if(steps.isEmpty())
+        return -1;
+
+    /* the candidate steps for the ids of the message, each list is in the order of the steps */
+    if(context.apidAscii && context.ctidAscii && !apidCtidIndex.isEmpty())
+    {
+        QHash<quint64, QVector<int> >::const_iterator it = apidCtidIndex.constFind(((quint64) context.apid << 32) | context.ctid);
+        if(it != apidCtidIndex.constEnd())
+            lists[count++] = &it.value();
+    }
+    /* a context id set by a plugin can be longer than 4 characters and contain the context id of the filter */
+    if(context.apidAscii && !context.ctidAscii && !apidCtidByApid.isEmpty())
+    {
+        QHash<quint32, QVector<int> >::const_iterator it = apidCtidByApid.constFind(context.apid);
+        if(it != apidCtidByApid.constEnd())
+            lists[count++] = &it.value();
+    }
+    if(context.apidAscii && !apidIndex.isEmpty())
+    {
+        QHash<quint32, QVector<int> >::const_iterator it = apidIndex.constFind(context.apid);
+        if(it != apidIndex.constEnd())
+            lists[count++] = &it.value();
+    }
+    if(context.ecuidAscii && !ecuidIndex.isEmpty())
+    {
+        QHash<quint32, QVector<int> >::const_iterator it = ecuidIndex.constFind(context.ecuid);
+        if(it != ecuidIndex.constEnd())
+            lists[count++] = &it.value();
+    }
+    if(!residual.isEmpty())
+        lists[count++] = &residual;
+
+    /* check the candidates in the order of the steps, the first match is returned */
+    while(true)
+    {
+        int next = -1;
+        for(int num = 0; num < count; num++)
+        {
+            if(pos[num] < lists[num]->size() && (next < 0 || lists[num]->at(pos[num]) < lists[next]->at(pos[next])))
+                next = num;
+        }
+        if(next < 0)
+            return -1;
+
+        int step = lists[next]->at(pos[next]++);
+        if(match(steps.at(step), context))
+            return step;
+    }
+}
+
+QDltFilterPlan::Step QDltFilterPlan::compileStep(const QDltFilter *filter, QDltPatternMatcher &headerMatcher, QDltPatternMatcher &payloadMatcher)
+{
+    Step step;
+
+    step.filter = filter;
+
+    if(filter->enableEcuid)
+        step.ecuidCheck = idFromAscii(filter->ecuid, step.ecuid) ? IdEquals : IdString;
+
+    if(filter->enableApid)
+    {
+        if(filter->enableRegexp_Appid)
+            step.apidCheck = IdRegexp;
+        else
+            step.apidCheck = idFromAscii(filter->apid, step.apid) ? IdEquals : IdString;
+    }
+
+    if(filter->enableCtid)
+    {
+        if(filter->enableRegexp_Context)
+            step.ctidCheck = IdRegexp;
+        else
+            step.ctidCheck = idFromAscii(filter->ctid, step.ctid) ? IdContains : IdString;
+        step.ctidLength = filter->ctid.size();
+    }
+
+    step.checkMessageId = filter->enableMessageId;
+    step.messageIdMin = filter->messageIdMin;
+    step.messageIdMax = filter->messageIdMax;
+
+    step.checkControl = filter->enableCtrlMsgs;
+    step.checkLogLevel = filter->enableLogLevelMin || filter->enableLogLevelMax;
+    step.logLevelMin = filter->enableLogLevelMin ? filter->logLevelMin : INT_MIN;
+    step.logLevelMax = filter->enableLogLevelMax ? filter->logLevelMax : INT_MAX;
+
+    if(filter->enableHeader)
+        step.headerCheck = filter->enableRegexp_Header ? TextRegexp : TextContains;
+    if(filter->enablePayload)
+        step.payloadCheck = filter->enableRegexp_Payload ? TextRegexp : TextContains;
+    if(step.headerCheck == TextContains)
+        step.headerPattern = headerMatcher.addPattern(filter->header, filter->ignoreCase_Header ? Qt::CaseInsensitive : Qt::CaseSensitive);
+    if(step.payloadCheck == TextContains)
+        step.payloadPattern = payloadMatcher.addPattern(filter->payload, filter->ignoreCase_Payload ? Qt::CaseInsensitive : Qt::CaseSensitive);
+
+    /* integer checks are free, regular expressions on ids are cheap, rendering text is expensive */
+    if(step.apidCheck == IdRegexp || step.ctidCheck == IdRegexp)
+        step.cost += 1;
+    if(step.headerCheck != TextNone)
+        step.cost += 2;
+    if(step.payloadCheck != TextNone)
+        step.cost += 4;
+
+    return step;
+}
+
+void QDltFilterPlan::Group::findAll(Context &context, QBitArray &matches) const
+{
+    matches.fill(false, steps.size());
+
+    /* only the steps found for the ids of the message and the residual steps can match */
+    if(context.apidAscii && context.ctidAscii)
+    {
+        const QVector<int> candidates = apidCtidIndex.value(((quint64) context.apid << 32) | context.ctid);
+        for(int num = 0; num < candidates.size(); num++)
+            if(match(steps.at(candidates.at(num)), context))
+                matches.setBit(steps.at(candidates.at(num)).position);
+    }
+    if(context.apidAscii && !context.ctidAscii)
+    {
+        const QVector<int> candidates = apidCtidByApid.value(context.apid);
+        for(int num = 0; num < candidates.size(); num++)
+            if(match(steps.at(candidates.at(num)), context))
+                matches.setBit(steps.at(candidates.at(num)).position);
+    }
+    if(context.apidAscii)
+    {
+        const QVector<int> candidates = apidIndex.value(context.apid);
+        for(int num = 0; num < candidates.size(); num++)
+            if(match(steps.at(candidates.at(num)), context))
+                matches.setBit(steps.at(candidates.at(num)).position);
+    }
+    if(context.ecuidAscii)
+    {
+        const QVector<int> candidates = ecuidIndex.value(context.ecuid);
+        for(int num = 0; num < candidates.size(); num++)
+            if(match(steps.at(candidates.at(num)), context))
+                matches.setBit(steps.at(candidates.at(num)).position);
+    }
+    for(int num = 0; num < residual.size(); num++)
+        if(match(steps.at(residual.at(num)), context))
+            matches.setBit(steps.at(residual.at(num)).position);
+}
+
+void QDltFilterPlan::matchEach(QDltMsg &msg, QDltStringCache *cache, qint64 index, QBitArray &matches) const
+{
+    Context context(*this, msg, cache, index);
+
+    positive.findAll(context, matches);
+}
+
+void QDltFilterPlan::matchEach(const QDltMsgView &msg, QBitArray &matches) const
+{
+    Context context(*this, msg);
+
+    positive.findAll(context, matches);
+}
+
+void QDltFilterPlan::matchEach(const QDltMsgTable &table, int row, QBitArray &matches) const
+{
+    Context context(*this, table, row);
+
+    positive.findAll(context, matches);
+}
+
+bool QDltFilterPlan::check(QDltMsg &msg, QDltStringCache *cache, qint64 index) const
+{
+    Context context(*this, msg, cache, index);
+
+    return check(context);
+}
+
+bool QDltFilterPlan::check(const QDltMsgView &msg) const
+{
+    Context context(*this, msg);
+
+    return check(context);
+}
+
+bool QDltFilterPlan::check(const QDltMsgTable &table, int row) const
+{
+    Context context(*this, table, row);
+
+    return check(context);
+}
+
+bool QDltFilterPlan::check(Context &context) const
+{
+    /* If there are no positive filters, the default case is to show all messages.
+     * Only negative filters will be applied */
+    if(!positive.steps.isEmpty() && positive.find(context) < 0)
+        return false;
+
+    return negative.find(context) < 0;
+}
+
+const QDltFilter *QDltFilterPlan::checkMarker(QDltMsg &msg, QDltStringCache *cache, qint64 index) const
+{
+    if(markers.steps.isEmpty())
+        return 0;
+
+    Context context(*this, msg, cache, index);
+    int step = markers.find(context);
+
+    return step >= 0 ? markers.steps.at(step).filter : 0;
+}
+
+int QDltFilterPlan::checkMarkerPosition(QDltMsg &msg, QDltStringCache *cache, qint64 index) const
+{
+    if(markers.steps.isEmpty())
+        return -1;
+
+    Context context(*this, msg, cache, index);
+    int step = markers.find(context);
+
+    return step >= 0 ? markers.steps.at(step).position : -1;
+}
+
+bool QDltFilterPlan::isHeaderOnly() const
+{
+    return headerOnly;
+}
+
+bool QDltFilterPlan::match(const Step &step, Context &context)
+{
+    const QDltFilter *filter = step.filter;
+
+    /* integer checks first, same conditions as QDltFilter::match() */
+    if(step.apidCheck == IdEquals && !(context.apidAscii && context.apid == step.apid))
+        return false;
+    if(step.ctidCheck == IdContains && context.ctidAscii && !containsId(context.ctid, step.ctid, step.ctidLength))
+        return false;
+    if(step.ecuidCheck == IdEquals && !(context.ecuidAscii && context.ecuid == step.ecuid))
+        return false;
+
+    if(step.checkMessageId)
+    {
+        if(step.messageIdMax == 0)
+        {
+            if(context.messageId != step.messageIdMin)
+                return false;
+        }
+        else if(context.messageId < step.messageIdMin || context.messageId >= step.messageIdMax)
+        {
+            return false;
+        }
+    }
+
+    if(step.checkControl && context.type != QDltMsg::DltTypeControl)
+        return false;
+    if(step.checkLogLevel && !(context.type == QDltMsg::DltTypeLog && context.subtype >= step.logLevelMin && context.subtype <= step.logLevelMax))
+        return false;
+
+    /* ids which can not be compared as integers */
+    if(step.ctidCheck == IdContains && !context.ctidAscii && !context.ctidString().contains(filter->ctid))
+        return false;
+    if(step.apidCheck == IdString && context.apidString() != filter->apid)
+        return false;
+    if(step.ctidCheck == IdString && !context.ctidString().contains(filter->ctid))
+        return false;
+    if(step.ecuidCheck == IdString && context.ecuidString() != filter->ecuid)
+        return false;
+
+    if(step.apidCheck == IdRegexp && !filter->appidRegularExpression.match(context.apidString()).hasMatch())
+        return false;
+    if(step.ctidCheck == IdRegexp && !filter->contextRegularExpression.match(context.ctidString()).hasMatch())
+        return false;
+
+    /* text is rendered only once for all filters */
+    if(step.headerCheck == TextRegexp && !filter->headerRegularExpression.match(context.headerText()).hasMatch())
+        return false;
+    if(step.headerCheck == TextContains && !context.headerContains(step.headerPattern))
+        return false;
+    if(step.payloadCheck == TextRegexp && !filter->payloadRegularExpression.match(context.payloadText()).hasMatch())
+        return false;
+    if(step.payloadCheck == TextContains && !context.payloadContains(step.payloadPattern))
+        return false;
+
+    return true;
+}
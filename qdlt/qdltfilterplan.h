@@ -0,0 +1,223 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltfilterplan.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_FILTER_PLAN_H
+#define QDLT_FILTER_PLAN_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QBitArray>
+
+#include "export_rules.h"
+#include "qdltpatternmatcher.h"
+
+class QDltFilter;
+class QDltMsg;
+class QDltMsgView;
+class QDltMsgTable;
+class QDltStringCache;
+
+//! Compiled evaluation plan of the positive and negative filters and markers of a filter list.
+/*!
+  The ids of the filters are converted once to 32 bit values, so a message is checked with
+  integer comparisons first. Regular expressions and header and payload text are checked last.
+  Filters without text checks are evaluated before filters with text checks, so expensive
+  filters are only evaluated if no cheap filter matched. The header and payload text of a
+  message are rendered at most once for all filters, and all literal header and payload texts
+  of the filters are searched in one scan of the message text, see QDltPatternMatcher.
+  Filters with an exact application id, and optionally a complete context id, or an exact ECU id
+  are indexed in hash tables by these ids. A message is only checked against the filters found
+  for its ids and the remaining filters with regular expressions or partial ids, so the time
+  to check a message does not grow with the number of exact id filters.
+  The result is the same as checking each filter with QDltFilter::match().
+  The plan keeps pointers to the filters and must be compiled again, when the filters change.
+  Checking messages can be done from several threads at the same time.
+*/
+class QDLT_EXPORT QDltFilterPlan
+{
+public:
+    //! Constructor of an empty plan, all messages match.
+    QDltFilterPlan();
+
+    //! Remove all filters from the plan.
+    void clear();
+
+    //! Compile the plan.
+    /*!
+      \param positive The enabled positive filters.
+      \param negative The enabled negative filters.
+      \param markers The enabled markers, in the order they are checked.
+    */
+    void compile(const QList<QDltFilter*> &positive, const QList<QDltFilter*> &negative,
+                 const QList<QDltFilter*> &markers = QList<QDltFilter*>());
+
+    //! Check if a message passes the filters.
+    /*!
+      \param msg The parsed and decoded message.
+      \param cache The cache of rendered strings, the strings are not cached if 0.
+      \param index The index of the message in the log file.
+      \return true if the message matches a positive filter, or there are no positive filters, and matches no negative filter.
+    */
+    bool check(QDltMsg &msg, QDltStringCache *cache, qint64 index) const;
+
+    //! Check if the header of a message passes the filters, without parsing the message.
+    /*!
+      Only valid if isHeaderOnly() is true.
+      \param msg The message to be checked.
+      \return true if the message passes the filters.
+    */
+    bool check(const QDltMsgView &msg) const;
+
+    //! Check if a message passes the filters with the header fields of the message table.
+    /*!
+      Only valid if isHeaderOnly() is true.
+      \param table The header fields of the messages of a log file.
+      \param row The row of the message in the table, the row must be valid.
+      \return true if the message passes the filters.
+    */
+    bool check(const QDltMsgTable &table, int row) const;
+
+    //! Check each positive filter separately.
+    /*!
+      \param msg The parsed and decoded message.
+      \param cache The cache of rendered strings, the strings are not cached if 0.
+      \param index The index of the message in the log file.
+      \param matches Set to one bit for each positive filter in the order of compile(), the bits of the matching filters are set.
+    */
+    void matchEach(QDltMsg &msg, QDltStringCache *cache, qint64 index, QBitArray &matches) const;
+
+    //! Check each positive filter separately with the header of a message, only valid if isHeaderOnly() is true.
+    void matchEach(const QDltMsgView &msg, QBitArray &matches) const;
+
+    //! Check each positive filter separately with a row of the message table, only valid if isHeaderOnly() is true.
+    void matchEach(const QDltMsgTable &table, int row, QBitArray &matches) const;
+
+    //! Get the first marker matching a message.
+    /*!
+      \param msg The parsed and decoded message.
+      \param cache The cache of rendered strings, the strings are not cached if 0.
+      \param index The index of the message in the log file.
+      \return The first matching marker in the order of compile(), 0 if no marker matches.
+    */
+    const QDltFilter *checkMarker(QDltMsg &msg, QDltStringCache *cache, qint64 index) const;
+
+    //! Get the position of the first marker matching a message.
+    /*!
+      \param msg The parsed and decoded message.
+      \param cache The cache of rendered strings, the strings are not cached if 0.
+      \param index The index of the message in the log file.
+      \return The position of the first matching marker in the list given to compile(), -1 if no marker matches.
+    */
+    int checkMarkerPosition(QDltMsg &msg, QDltStringCache *cache, qint64 index) const;
+
+    //! Check if no positive or negative filter of the plan needs the header or payload text.
+    bool isHeaderOnly() const;
+
+    //! Get the number of compiled filters.
+    int size() const { return positive.steps.size() + negative.steps.size() + markers.steps.size(); }
+
+    //! Get the number of compiled filters, which are not found by their ids and checked for each message.
+    int residualSize() const { return positive.residual.size() + negative.residual.size() + markers.residual.size(); }
+
+private:
+    //! How an id of the message is checked.
+    typedef enum { IdNone = 0, IdEquals, IdContains, IdRegexp, IdString } IdCheck;
+
+    //! How a text of the message is checked.
+    typedef enum { TextNone = 0, TextContains, TextRegexp } TextCheck;
+
+    //! One compiled filter.
+    class Step
+    {
+    public:
+        Step();
+
+        const QDltFilter *filter;   //!< the filter, for regular expressions and strings
+        int position;               //!< position of the filter in the list given to compile()
+        int cost;                   //!< filters with lower cost are evaluated first
+
+        IdCheck ecuidCheck;
+        IdCheck apidCheck;
+        IdCheck ctidCheck;
+        quint32 ecuid;
+        quint32 apid;
+        quint32 ctid;
+        int ctidLength;
+
+        bool checkMessageId;
+        unsigned int messageIdMin;
+        unsigned int messageIdMax;
+
+        bool checkControl;
+        bool checkLogLevel;
+        int logLevelMin;
+        int logLevelMax;
+
+        TextCheck headerCheck;
+        TextCheck payloadCheck;
+        int headerPattern;          //!< id of the header text in the header matcher
+        int payloadPattern;         //!< id of the payload text in the payload matcher
+    };
+
+    class Context;
+
+    //! Compiled filters of one kind, indexed by their ids.
+    class Group
+    {
+    public:
+        void clear();
+
+        //! Compile the filters, sorted by cost if the order does not matter.
+        void compile(const QList<QDltFilter*> &filters, bool keepOrder,
+                     QDltPatternMatcher &headerMatcher, QDltPatternMatcher &payloadMatcher);
+
+        //! Get the first step matching the message, -1 if no step matches.
+        int find(Context &context) const;
+
+        //! Set the bits of the positions of all steps matching the message.
+        void findAll(Context &context, QBitArray &matches) const;
+
+        QVector<Step> steps;                            //!< the compiled filters
+        QHash<quint64, QVector<int> > apidCtidIndex;    //!< steps with exact application and complete context id
+        QHash<quint32, QVector<int> > apidCtidByApid;   //!< the same steps by application id, for context ids longer than 4 characters
+        QHash<quint32, QVector<int> > apidIndex;        //!< other steps with exact application id
+        QHash<quint32, QVector<int> > ecuidIndex;       //!< other steps with exact ECU id
+        QVector<int> residual;                          //!< all other steps
+    };
+
+    //! Compile one filter, literal texts are added to the matchers.
+    static Step compileStep(const QDltFilter *filter, QDltPatternMatcher &headerMatcher, QDltPatternMatcher &payloadMatcher);
+
+    //! Check if one step matches the message.
+    static bool match(const Step &step, Context &context);
+
+    //! Check a message with the positive and negative filters.
+    bool check(Context &context) const;
+
+    Group positive;
+    Group negative;
+    Group markers;
+    QDltPatternMatcher headerMatcher;
+    QDltPatternMatcher payloadMatcher;
+    bool headerOnly;
+};
+
+#endif // QDLT_FILTER_PLAN_H
@@ -0,0 +1,280 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltindex.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QtDebug>
+
+#include "qdltindex.h"
+
+QDltIndex::QDltIndex()
+{
+    count = 0;
+    lastValue = 0;
+    mappedValues = 0;
+}
+
+QDltIndex::QDltIndex(const QVector<qint64> &values)
+{
+    count = 0;
+    lastValue = 0;
+    mappedValues = 0;
+    append(values);
+}
+
+QDltIndex &QDltIndex::operator=(const QVector<qint64> &values)
+{
+    clear();
+    append(values);
+    return *this;
+}
+
+void QDltIndex::clear()
+{
+    segments.clear();
+    count = 0;
+    lastValue = 0;
+    mappedFile.clear();
+    mappedValues = 0;
+}
+
+void QDltIndex::reserve(int size)
+{
+    segments.reserve((size + QDLT_INDEX_SEGMENT_SIZE - 1) >> QDLT_INDEX_SEGMENT_SHIFT);
+}
+
+void QDltIndex::append(qint64 value)
+{
+    if(mappedValues)
+        copyMappedValues();
+
+    int num = count & (QDLT_INDEX_SEGMENT_SIZE - 1);
+    if(num == 0)
+    {
+        /* start a new segment, the space for all its values is allocated at once */
+        Segment segment;
+        segment.encoding = Segment::Deltas;
+        segment.base = value;
+        segment.checkpoints.reserve(QDLT_INDEX_SEGMENT_SIZE / QDLT_INDEX_CHECKPOINT_SIZE);
+        segment.deltas.reserve(QDLT_INDEX_SEGMENT_SIZE);
+        segments.append(segment);
+        lastValue = value;
+    }
+
+    Segment &segment = segments.last();
+    qint64 delta = value - lastValue;
+    lastValue = value;
+    count++;
+
+    if(segment.encoding == Segment::Deltas)
+    {
+        if(delta >= 0 && delta <= 0xffff)
+        {
+            /* the offset of a checkpoint is at most the segment size times the maximum delta */
+            if((num & (QDLT_INDEX_CHECKPOINT_SIZE - 1)) == 0)
+                segment.checkpoints.append((qint32) (value - segment.base));
+            segment.deltas.append((quint16) delta);
+            return;
+        }
+
+        /* values not in ascending order or too far apart, store offsets */
+        QVector<qint64> decoded(QDLT_INDEX_SEGMENT_SIZE);
+        decodeSegment(segments.size() - 1, decoded.data());
+        segment.offsets.reserve(QDLT_INDEX_SEGMENT_SIZE);
+        for(int pos = 0; pos < num; pos++)
+            segment.offsets.append((qint32) (decoded.at(pos) - segment.base));
+        segment.checkpoints = QVector<qint32>();
+        segment.deltas = QVector<quint16>();
+        segment.encoding = Segment::Offsets;
+    }
+
+    if(segment.encoding == Segment::Offsets)
+    {
+        qint64 offset = value - segment.base;
+        if(offset >= -0x7fffffffLL - 1 && offset <= 0x7fffffffLL)
+        {
+            segment.offsets.append((qint32) offset);
+            return;
+        }
+
+        /* values too far apart, e.g. after a big corrupted part of a file, store full values */
+        segment.values.reserve(QDLT_INDEX_SEGMENT_SIZE);
+        for(int pos = 0; pos < segment.offsets.size(); pos++)
+            segment.values.append(segment.base + segment.offsets.at(pos));
+        segment.offsets = QVector<qint32>();
+        segment.encoding = Segment::Values;
+    }
+
+    segment.values.append(value);
+}
+
+void QDltIndex::append(const QVector<qint64> &values)
+{
+    reserve(count + values.size());
+    for(int num = 0; num < values.size(); num++)
+        append(values.at(num));
+}
+
+void QDltIndex::append(const QDltIndex &values)
+{
+    if(&values == this)
+    {
+        QDltIndex copy(values);
+        append(copy);
+        return;
+    }
+
+    reserve(count + values.size());
+
+    if(values.mappedValues)
+    {
+        for(int num = 0; num < values.count; num++)
+            append(values.mappedValues[num]);
+        return;
+    }
+
+    QVector<qint64> decoded(QDLT_INDEX_SEGMENT_SIZE);
+    for(int num = 0; num < values.segments.size(); num++)
+    {
+        int size = values.decodeSegment(num, decoded.data());
+        for(int pos = 0; pos < size; pos++)
+            append(decoded.at(pos));
+    }
+}
+
+int QDltIndex::decodeSegment(int num, qint64 *values) const
+{
+    const Segment &segment = segments.at(num);
+    int size = (num == segments.size() - 1) ? count - (num << QDLT_INDEX_SEGMENT_SHIFT) : QDLT_INDEX_SEGMENT_SIZE;
+
+    if(segment.encoding == Segment::Values)
+    {
+        for(int pos = 0; pos < size; pos++)
+            values[pos] = segment.values.at(pos);
+    }
+    else if(segment.encoding == Segment::Offsets)
+    {
+        for(int pos = 0; pos < size; pos++)
+            values[pos] = segment.base + segment.offsets.at(pos);
+    }
+    else
+    {
+        /* while a segment is converted, the new value is already counted */
+        size = qMin(size, segment.deltas.size());
+        qint64 value = segment.base;
+        for(int pos = 0; pos < size; pos++)
+        {
+            value += segment.deltas.at(pos);
+            values[pos] = value;
+        }
+    }
+
+    return size;
+}
+
+bool QDltIndex::mapFile(const QString &filename, qint64 offset, int size)
+{
+    clear();
+
+    if(size <= 0)
+        return true;
+
+    QSharedPointer<QFile> file(new QFile(filename));
+    if(!file->open(QIODevice::ReadOnly))
+        return false;
+
+    uchar *data = file->map(offset, (qint64) size * sizeof(qint64));
+    if(!data)
+    {
+        qDebug() << "Mapping of index file" << filename << "failed" << file->errorString();
+        return false;
+    }
+
+    mappedFile = file;
+    mappedValues = (const qint64 *) data;
+    count = size;
+
+    return true;
+}
+
+void QDltIndex::copyMappedValues()
+{
+    /* keep the file mapped, until all values are copied */
+    QSharedPointer<QFile> file = mappedFile;
+    const qint64 *values = mappedValues;
+    int size = count;
+
+    clear();
+    reserve(size);
+    for(int num = 0; num < size; num++)
+        append(values[num]);
+}
+
+int QDltIndex::indexOf(qint64 value) const
+{
+    if(mappedValues)
+    {
+        for(int num = 0; num < count; num++)
+        {
+            if(mappedValues[num] == value)
+                return num;
+        }
+        return -1;
+    }
+
+    QVector<qint64> decoded(QDLT_INDEX_SEGMENT_SIZE);
+    for(int num = 0; num < segments.size(); num++)
+    {
+        int size = decodeSegment(num, decoded.data());
+        for(int pos = 0; pos < size; pos++)
+        {
+            if(decoded.at(pos) == value)
+                return (num << QDLT_INDEX_SEGMENT_SHIFT) + pos;
+        }
+    }
+    return -1;
+}
+
+QVector<qint64> QDltIndex::toVector() const
+{
+    QVector<qint64> values(count);
+
+    if(mappedValues)
+    {
+        for(int num = 0; num < count; num++)
+            values[num] = mappedValues[num];
+        return values;
+    }
+
+    for(int num = 0; num < segments.size(); num++)
+        decodeSegment(num, values.data() + (num << QDLT_INDEX_SEGMENT_SHIFT));
+    return values;
+}
+
+qint64 QDltIndex::memoryUsage() const
+{
+    qint64 bytes = sizeof(*this) + (qint64) segments.capacity() * sizeof(Segment);
+    for(int num = 0; num < segments.size(); num++)
+    {
+        const Segment &segment = segments.at(num);
+        bytes += (qint64) segment.checkpoints.capacity() * sizeof(qint32);
+        bytes += (qint64) segment.deltas.capacity() * sizeof(quint16);
+        bytes += (qint64) segment.offsets.capacity() * sizeof(qint32);
+        bytes += (qint64) segment.values.capacity() * sizeof(qint64);
+    }
+    return bytes;
+}
@@ -0,0 +1,197 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltindex.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_INDEX_H
+#define QDLT_INDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QFile>
+#include <QSharedPointer>
+
+#include "export_rules.h"
+
+//! Compact index of file positions or message rows.
+/*!
+  The values are stored in segments of a fixed number of entries.
+  Each segment stores the difference of each value to the previous value as 16 bit delta,
+  which is enough for the positions of DLT messages and for message rows in file order,
+  so one entry needs a little more than 2 bytes instead of 8 bytes.
+  Every QDLT_INDEX_CHECKPOINT_SIZE values the offset to the first value of the segment is stored,
+  so random access only sums up a few deltas.
+  A segment with a difference, which does not fit into 16 bit, e.g. a sorted index,
+  stores 32 bit offsets to its first value, and full 64 bit values, if the offsets do not fit.
+  Appending never copies already stored values, and copies of the index share the
+  segments until they are modified.
+  Alternatively the values can be used directly from a memory mapped file with mapFile().
+*/
+class QDLT_EXPORT QDltIndex
+{
+public:
+    //! Constructor.
+    QDltIndex();
+
+    //! Create an index with the values of a vector.
+    QDltIndex(const QVector<qint64> &values);
+
+    //! Replace the index with the values of a vector.
+    QDltIndex &operator=(const QVector<qint64> &values);
+
+    //! Get the number of values.
+    int size() const { return count; }
+
+    //! Check if the index contains no values.
+    bool isEmpty() const { return count == 0; }
+
+    //! Remove all values.
+    void clear();
+
+    //! Reserve space for a number of values.
+    /*!
+      Only the list of segments is reserved, segments are allocated when they are used.
+      \param size The expected number of values.
+    */
+    void reserve(int size);
+
+    //! Append a value.
+    void append(qint64 value);
+
+    //! Append all values of a vector.
+    void append(const QVector<qint64> &values);
+
+    //! Append all values of another index.
+    void append(const QDltIndex &values);
+
+    //! Get a value.
+    /*!
+      \param index The position in the index, must be in range.
+      \return the value
+    */
+    qint64 at(int index) const
+    {
+        if(mappedValues)
+            return mappedValues[index];
+        const Segment &segment = segments.at(index >> QDLT_INDEX_SEGMENT_SHIFT);
+        int num = index & (QDLT_INDEX_SEGMENT_SIZE - 1);
+        if(segment.encoding == Segment::Offsets)
+            return segment.base + segment.offsets.at(num);
+        if(segment.encoding == Segment::Values)
+            return segment.values.at(num);
+        int first = num & ~(QDLT_INDEX_CHECKPOINT_SIZE - 1);
+        qint64 value = segment.base + segment.checkpoints.at(num >> QDLT_INDEX_CHECKPOINT_SHIFT);
+        const quint16 *deltas = segment.deltas.constData();
+        for(int pos = first + 1; pos <= num; pos++)
+            value += deltas[pos];
+        return value;
+    }
+
+    //! Get a value.
+    qint64 operator[](int index) const { return at(index); }
+
+    //! Get the last value, the index must not be empty.
+    qint64 last() const { return at(count - 1); }
+
+    //! Use the values stored in a file instead of own memory.
+    /*!
+      The file is mapped into memory, so the values are available immediately and are only
+      read from disk when accessed. The mapping is shared by all copies of the index.
+      It is replaced by own segments, when the index is modified.
+      \param filename The file containing the values as native 64 bit integers.
+      \param offset The file position of the first value.
+      \param size The number of values.
+      \return true if the file was mapped, false if an error occured.
+    */
+    bool mapFile(const QString &filename, qint64 offset, int size);
+
+    //! Check if the values are used from a mapped file.
+    bool isMapped() const { return mappedValues != 0; }
+
+    //! Find the position of a value.
+    /*!
+      \param value The value to search for.
+      \return the first position of the value, -1 if not found.
+    */
+    int indexOf(qint64 value) const;
+
+    //! Copy all values to a vector.
+    QVector<qint64> toVector() const;
+
+    //! Get the memory allocated by the index.
+    /*!
+      Mapped values are not counted, they are part of the page cache.
+      \return the number of bytes
+    */
+    qint64 memoryUsage() const;
+
+private:
+    enum { QDLT_INDEX_SEGMENT_SHIFT = 12, QDLT_INDEX_SEGMENT_SIZE = 1 << QDLT_INDEX_SEGMENT_SHIFT };
+    enum { QDLT_INDEX_CHECKPOINT_SHIFT = 5, QDLT_INDEX_CHECKPOINT_SIZE = 1 << QDLT_INDEX_CHECKPOINT_SHIFT };
+
+    //! One segment of the index.
+    struct Segment
+    {
+        //! How the values of the segment are stored.
+        enum Encoding { Deltas, Offsets, Values };
+
+        Encoding encoding;
+
+        //! The first value of the segment.
+        qint64 base;
+
+        //! Offsets to base of every QDLT_INDEX_CHECKPOINT_SIZE value, if deltas are used.
+        QVector<qint32> checkpoints;
+
+        //! Differences of the values to the previous value, the first one is 0.
+        QVector<quint16> deltas;
+
+        //! Offsets of the values to base, only used if a difference does not fit into 16 bit.
+        QVector<qint32> offsets;
+
+        //! Full values, only used if the offsets do not fit into 32 bit.
+        QVector<qint64> values;
+    };
+
+    //! All segments, only the last one can be incomplete.
+    QVector<Segment> segments;
+
+    //! Copy mapped values to own segments.
+    void copyMappedValues();
+
+    //! Decode all values of a segment in order.
+    /*!
+      \param num The number of the segment.
+      \param values Buffer for QDLT_INDEX_SEGMENT_SIZE values.
+      \return the number of values of the segment.
+    */
+    int decodeSegment(int num, qint64 *values) const;
+
+    //! The number of values.
+    int count;
+
+    //! The last appended value, the next delta is relative to it.
+    qint64 lastValue;
+
+    //! The mapped file, if values are used from a file.
+    QSharedPointer<QFile> mappedFile;
+
+    //! The mapped values, NULL if values are stored in segments.
+    const qint64 *mappedValues;
+};
+
+#endif // QDLT_INDEX_H
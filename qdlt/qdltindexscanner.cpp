@@ -0,0 +1,487 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltindexscanner.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <string.h>
+#include <limits>
+
+#include "qdltindexscanner.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QDLT_SCANNER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(QDLT_SCANNER_SSE2) && ((defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))) || defined(_MSC_VER))
+#define QDLT_SCANNER_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* offset of the message length in the standard header, counted from the beginning of the storage header */
+#define QDLT_SCANNER_LENGTH_OFFSET 18
+
+/* size of the storage header, which is not part of the message length */
+#define QDLT_SCANNER_STORAGE_HEADER_SIZE 16
+
+/* size of the storage header plus the standard header */
+#define QDLT_SCANNER_MIN_HEADER_SIZE 20
+
+/* size of the storage header pattern 'D' 'L' 'T' 0x01 */
+#define QDLT_SCANNER_PATTERN_SIZE 4
+
+/* number of following messages checked, before a message found in the middle of a file is trusted */
+#define QDLT_SCANNER_SYNC_CHAIN_LENGTH 8
+
+static inline bool isStorageHeader(const char *ptr)
+{
+    return ptr[0] == 'D' && ptr[1] == 'L' && ptr[2] == 'T' && ptr[3] == 0x01;
+}
+
+static inline int firstBit(unsigned int mask)
+{
+#if defined(_MSC_VER)
+    unsigned long bit;
+    _BitScanForward(&bit, mask);
+    return (int) bit;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+static const char *findStorageHeaderScalar(const char *begin, const char *end)
+{
+    if(end - begin < QDLT_SCANNER_PATTERN_SIZE)
+        return end;
+
+    /* last possible start of a complete pattern */
+    const char *last = end - (QDLT_SCANNER_PATTERN_SIZE - 1);
+    const char *ptr = begin;
+
+    while(ptr < last)
+    {
+        ptr = (const char *) memchr(ptr, 'D', last - ptr);
+        if(!ptr)
+            return end;
+        if(isStorageHeader(ptr))
+            return ptr;
+        ptr++;
+    }
+
+    return end;
+}
+
+#ifdef QDLT_SCANNER_SSE2
+static const char *findStorageHeaderSse2(const char *begin, const char *end)
+{
+    const __m128i patternD = _mm_set1_epi8('D');
+    const __m128i patternL = _mm_set1_epi8('L');
+    const __m128i patternT = _mm_set1_epi8('T');
+    const __m128i patternVersion = _mm_set1_epi8(0x01);
+    const char *ptr = begin;
+
+    /* compare 16 candidate positions at once, each candidate needs three more bytes */
+    while(end - ptr >= 16 + QDLT_SCANNER_PATTERN_SIZE - 1)
+    {
+        __m128i match = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) ptr), patternD);
+        match = _mm_and_si128(match, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (ptr + 1)), patternL));
+        match = _mm_and_si128(match, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (ptr + 2)), patternT));
+        match = _mm_and_si128(match, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (ptr + 3)), patternVersion));
+
+        unsigned int mask = (unsigned int) _mm_movemask_epi8(match);
+        if(mask)
+            return ptr + firstBit(mask);
+
+        ptr += 16;
+    }
+
+    return findStorageHeaderScalar(ptr, end);
+}
+#endif
+
+#ifdef QDLT_SCANNER_AVX2
+#if !defined(_MSC_VER)
+__attribute__((target("avx2")))
+#endif
+static const char *findStorageHeaderAvx2(const char *begin, const char *end)
+{
+    const __m256i patternD = _mm256_set1_epi8('D');
+    const __m256i patternL = _mm256_set1_epi8('L');
+    const __m256i patternT = _mm256_set1_epi8('T');
+    const __m256i patternVersion = _mm256_set1_epi8(0x01);
+    const char *ptr = begin;
+
+    /* compare 32 candidate positions at once, each candidate needs three more bytes */
+    while(end - ptr >= 32 + QDLT_SCANNER_PATTERN_SIZE - 1)
+    {
+        __m256i match = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) ptr), patternD);
+        match = _mm256_and_si256(match, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) (ptr + 1)), patternL));
+        match = _mm256_and_si256(match, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) (ptr + 2)), patternT));
+        match = _mm256_and_si256(match, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) (ptr + 3)), patternVersion));
+
+        unsigned int mask = (unsigned int) _mm256_movemask_epi8(match);
+        if(mask)
+            return ptr + firstBit(mask);
+
+        ptr += 32;
+    }
+
+    return findStorageHeaderSse2(ptr, end);
+}
+
+static bool cpuSupportsAvx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if(info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    /* OSXSAVE and AVX, and the OS must save the YMM registers */
+    if((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+        return false;
+    if((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+typedef const char *(*FindStorageHeaderFunction)(const char *begin, const char *end);
+
+static FindStorageHeaderFunction selectKernel(QString *name)
+{
+#ifdef QDLT_SCANNER_AVX2
+    if(cpuSupportsAvx2())
+    {
+        *name = "avx2";
+        return findStorageHeaderAvx2;
+    }
+#endif
+#ifdef QDLT_SCANNER_SSE2
+    *name = "sse2";
+    return findStorageHeaderSse2;
+#else
+    *name = "scalar";
+    return findStorageHeaderScalar;
+#endif
+}
+
+class QDltIndexScannerKernel
+{
+public:
+    QDltIndexScannerKernel() { find = selectKernel(&name); }
+
+    FindStorageHeaderFunction find;
+    QString name;
+};
+
+static const QDltIndexScannerKernel &kernel()
+{
+    /* selected once on first use, initialisation of static locals is thread safe */
+    static const QDltIndexScannerKernel instance;
+    return instance;
+}
+
+const char *QDltIndexScanner::findStorageHeader(const char *begin, const char *end)
+{
+    return kernel().find(begin, end);
+}
+
+QString QDltIndexScanner::getKernelName()
+{
+    return kernel().name;
+}
+
+QDltIndexScanner::QDltIndexScanner(qint64 fileSize, qint64 startPos)
+{
+    reset(fileSize, startPos);
+}
+
+void QDltIndexScanner::reset(qint64 _fileSize, qint64 _startPos)
+{
+    fileSize = _fileSize;
+    startPos = _startPos;
+    currentPos = 0;
+    nextPos = 0;
+    searchPos = _startPos;
+    resyncPos = 0;
+    limit = std::numeric_limits<qint64>::max();
+    limitPos = -1;
+    errors = 0;
+    synced = false;
+    readingLength = false;
+    lengthBytes = 0;
+    length = 0;
+    tailSize = 0;
+    tailPos = 0;
+}
+
+void QDltIndexScanner::setLimit(qint64 _limit)
+{
+    limit = (_limit < 0) ? std::numeric_limits<qint64>::max() : _limit;
+}
+
+QDltIndexScanner::ScanResult QDltIndexScanner::foundHeader(qint64 headerPos, QDltIndex &index)
+{
+    if(!synced)
+    {
+        /* first message detected or first message after an error */
+        if(headerPos != startPos)
+        {
+            /* first message not at beginning or error occured before */
+            errors++;
+        }
+    }
+    else if(headerPos == nextPos)
+    {
+        /* add message only when next message is in the correct position in relationship to this message */
+        index.append(currentPos);
+    }
+    else
+    {
+        /* header detected after end of message, start search for new message
+           back after the last header found, the current message is dropped */
+        resyncPos = currentPos + QDLT_SCANNER_PATTERN_SIZE;
+        searchPos = resyncPos;
+        synced = false;
+        readingLength = false;
+        tailSize = 0;
+        return ScanResync;
+    }
+
+    if(headerPos >= limit)
+    {
+        /* this message is indexed by the next part of the file */
+        limitPos = headerPos;
+        return ScanLimit;
+    }
+
+    /* follow the length chain starting with this message */
+    currentPos = headerPos;
+    readingLength = true;
+    lengthBytes = 0;
+    length = 0;
+    tailSize = 0;
+
+    return ScanContinue;
+}
+
+QDltIndexScanner::ScanResult QDltIndexScanner::scan(const char *data, qint64 size, qint64 pos, QDltIndex &index)
+{
+    const qint64 endPos = pos + size;
+    ScanResult result;
+
+    if(size <= 0)
+        return ScanContinue;
+
+    /* check for a pattern split between the last buffers and this buffer */
+    char joined[2 * (QDLT_SCANNER_PATTERN_SIZE - 1)];
+    int joinedSize = 0;
+    qint64 joinedPos = tailPos;
+    if(tailSize > 0)
+    {
+        memcpy(joined, tail, tailSize);
+        joinedSize = tailSize;
+        for(int num = 0; num < QDLT_SCANNER_PATTERN_SIZE - 1 && num < size; num++)
+            joined[joinedSize++] = data[num];
+
+        qint64 headerPos = -1;
+        int num;
+        for(num = 0; num < tailSize && num + QDLT_SCANNER_PATTERN_SIZE <= joinedSize; num++)
+        {
+            if(isStorageHeader(joined + num))
+            {
+                headerPos = tailPos + num;
+                break;
+            }
+        }
+        tailSize = 0;
+
+        /* start positions, which could not be checked yet, are searched again */
+        searchPos = tailPos + num;
+
+        if(headerPos >= 0)
+        {
+            joinedSize = 0;
+            result = foundHeader(headerPos, index);
+            if(result != ScanContinue)
+                return result;
+        }
+    }
+
+    while(true)
+    {
+        /* follow the length chain directly, as long as the headers are inside of this buffer */
+        while(readingLength && lengthBytes == 0 && currentPos + QDLT_SCANNER_MIN_HEADER_SIZE <= endPos)
+        {
+            const char *ptr = data + (currentPos + QDLT_SCANNER_LENGTH_OFFSET - pos);
+            qint64 next = currentPos + (quint16) (((unsigned char) ptr[0] << 8) | (unsigned char) ptr[1]) + QDLT_SCANNER_STORAGE_HEADER_SIZE;
+            if(next == fileSize || next < currentPos + QDLT_SCANNER_MIN_HEADER_SIZE || next >= limit ||
+               next + QDLT_SCANNER_PATTERN_SIZE > endPos || !isStorageHeader(data + (next - pos)))
+                break; // handled by the generic path below
+            index.append(currentPos);
+            currentPos = next;
+            synced = true;
+        }
+
+        /* read the message length of the current message, message length is stored in big endian */
+        while(readingLength)
+        {
+            if(lengthBytes < 2)
+            {
+                qint64 lengthPos = currentPos + QDLT_SCANNER_LENGTH_OFFSET + lengthBytes;
+                if(lengthPos >= endPos)
+                    return ScanContinue; // continue in next buffer
+
+                length = (quint16) ((length << 8) | (unsigned char) data[lengthPos - pos]);
+                lengthBytes++;
+            }
+
+            if(lengthBytes == 2)
+            {
+                readingLength = false;
+                synced = true;
+                nextPos = currentPos + length + QDLT_SCANNER_STORAGE_HEADER_SIZE;
+                if(nextPos == fileSize)
+                {
+                    /* last message found in file */
+                    index.append(currentPos);
+                    return ScanFinished;
+                }
+                /* move directly to next message, the headers of this message are never searched */
+                searchPos = qMax(currentPos + QDLT_SCANNER_MIN_HEADER_SIZE, nextPos);
+            }
+        }
+
+        /* search the next storage header */
+        if(searchPos >= endPos)
+            return ScanContinue;
+
+        qint64 from = qMax(searchPos, pos);
+        const char *end = data + size;
+        const char *found;
+
+        /* in most cases the next message starts exactly at the expected position */
+        if(synced && from == nextPos && endPos - from >= QDLT_SCANNER_PATTERN_SIZE && isStorageHeader(data + (from - pos)))
+            found = data + (from - pos);
+        else
+            found = findStorageHeader(data + (from - pos), end);
+
+        if(found == end)
+        {
+            /* keep the last bytes, the pattern could be continued in the next buffer */
+            qint64 tailStart = qMax(searchPos, endPos - (QDLT_SCANNER_PATTERN_SIZE - 1));
+            tailSize = 0;
+            tailPos = tailStart;
+            for(qint64 num = tailStart; num < endPos; num++)
+            {
+                if(num >= pos)
+                    tail[tailSize++] = data[num - pos];
+                else if(num - joinedPos < joinedSize)
+                    tail[tailSize++] = joined[num - joinedPos]; // very small buffer, byte from an earlier buffer
+            }
+            searchPos = endPos;
+            return ScanContinue;
+        }
+
+        result = foundHeader(pos + (found - data), index);
+        if(result != ScanContinue)
+            return result;
+    }
+}
+
+qint64 QDltIndexScanner::findSyncPosition(const char *data, qint64 size, qint64 pos, qint64 fileSize, qint64 &resumePos)
+{
+    const qint64 endPos = pos + size;
+    const char *end = data + size;
+    const char *found = data;
+
+    while(true)
+    {
+        found = findStorageHeader(found, end);
+        if(found == end)
+        {
+            /* the last bytes could be the beginning of a pattern */
+            resumePos = qMax(pos + 1, endPos - (QDLT_SCANNER_PATTERN_SIZE - 1));
+            return -1;
+        }
+
+        qint64 headerPos = pos + (found - data);
+
+        /* check the length chain starting at the found pattern */
+        qint64 current = headerPos;
+        int links = 0;
+        bool valid = false;
+        bool leftBuffer = false;
+        while(true)
+        {
+            if(current + QDLT_SCANNER_MIN_HEADER_SIZE > endPos)
+            {
+                leftBuffer = true;
+                break;
+            }
+            const char *ptr = data + (current + QDLT_SCANNER_LENGTH_OFFSET - pos);
+            qint64 next = current + (quint16) (((unsigned char) ptr[0] << 8) | (unsigned char) ptr[1]) + QDLT_SCANNER_STORAGE_HEADER_SIZE;
+            if(next == fileSize)
+            {
+                /* last message of the file */
+                valid = true;
+                break;
+            }
+            if(next < current + QDLT_SCANNER_MIN_HEADER_SIZE)
+                break; // wrong length
+            if(next + QDLT_SCANNER_PATTERN_SIZE > endPos)
+            {
+                leftBuffer = true;
+                break;
+            }
+            if(!isStorageHeader(data + (next - pos)))
+                break;
+            current = next;
+            if(++links >= QDLT_SCANNER_SYNC_CHAIN_LENGTH)
+            {
+                valid = true;
+                break;
+            }
+        }
+
+        if(leftBuffer)
+        {
+            if(headerPos > pos && endPos < fileSize)
+            {
+                /* check again with a buffer starting at this pattern */
+                resumePos = headerPos;
+                return -1;
+            }
+            /* the chain can not be checked any further */
+            valid = true;
+        }
+
+        if(valid)
+            return headerPos;
+
+        found++;
+    }
+}
@@ -0,0 +1,177 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltindexscanner.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_INDEX_SCANNER_H
+#define QDLT_INDEX_SCANNER_H
+
+#include <QString>
+#include <QVector>
+
+#include "export_rules.h"
+#include "qdltindex.h"
+
+//! Find the start of all DLT messages in a DLT log file.
+/*!
+  The scanner searches the storage header pattern 'D' 'L' 'T' 0x01 and follows
+  the length chain of the standard header from one message to the next.
+  A message is only added to the index, when the next message starts exactly
+  at the position calculated from its length, or when it ends exactly at the end of the file.
+  The file content must be passed in file order with scan().
+  If scan() returns ScanResync, the caller must continue reading at getResyncPosition().
+  This class is not thread safe, use one instance per file and thread.
+*/
+class QDLT_EXPORT QDltIndexScanner
+{
+public:
+
+    //! The result of one call of scan().
+    typedef enum { ScanContinue = 0, ScanResync, ScanFinished, ScanLimit } ScanResult;
+
+    //! Constructor.
+    /*!
+      \param fileSize The size of the scanned file, used to detect the last message.
+      \param startPos The file position where scanning starts.
+    */
+    QDltIndexScanner(qint64 fileSize = 0, qint64 startPos = 0);
+
+    //! Reset the scanner to start a new scan.
+    /*!
+      \param fileSize The size of the scanned file, used to detect the last message.
+      \param startPos The file position where scanning starts.
+    */
+    void reset(qint64 fileSize, qint64 startPos = 0);
+
+    //! Stop scanning at the first message starting at or behind a file position.
+    /*!
+      Used to index a file in several parts, the reached message is not added to the index.
+      \param limit The file position, -1 to scan until the end of the file.
+    */
+    void setLimit(qint64 limit);
+
+    //! Scan the next buffer of the file.
+    /*!
+      Found message positions are appended to index.
+      \param data The buffer read from the file.
+      \param size The size of the buffer.
+      \param pos The file position of the first byte of the buffer.
+      \param index The index, where the positions of found messages are appended.
+      \return ScanContinue if the next buffer must be passed, ScanResync if reading must continue
+      at getResyncPosition(), ScanFinished if the last message of the file was found,
+      ScanLimit if the message at getLimitPosition() behind the limit was reached.
+    */
+    ScanResult scan(const char *data, qint64 size, qint64 pos, QDltIndex &index);
+
+    //! Get the file position where reading must continue after ScanResync.
+    /*!
+      \return the file position
+    */
+    qint64 getResyncPosition() const { return resyncPos; }
+
+    //! Get the position of the first message behind the limit after ScanLimit.
+    /*!
+      \return the file position
+    */
+    qint64 getLimitPosition() const { return limitPos; }
+
+    //! Get the number of wrong message headers found since the last reset.
+    /*!
+      \return the number of errors
+    */
+    qint64 getErrors() const { return errors; }
+
+    //! Find the first storage header pattern in a buffer.
+    /*!
+      The pattern must be completely inside of the buffer.
+      Uses AVX2 or SSE2 if available on this CPU, else a scalar search.
+      \param begin The start of the buffer.
+      \param end The end of the buffer.
+      \return pointer to the 'D' of the first pattern found, end if no pattern was found.
+    */
+    static const char *findStorageHeader(const char *begin, const char *end);
+
+    //! Find a message start, which can be trusted, in a buffer somewhere in the middle of a file.
+    /*!
+      A storage header pattern is only accepted, if the length chain starting there is followed
+      by further storage headers, so a pattern inside of a payload is not used.
+      \param data The buffer read from the file.
+      \param size The size of the buffer.
+      \param pos The file position of the first byte of the buffer.
+      \param fileSize The size of the file.
+      \param resumePos Where the search must continue with the next buffer, if no message was found.
+      \return the file position of the message, -1 if no message was found in this buffer.
+    */
+    static qint64 findSyncPosition(const char *data, qint64 size, qint64 pos, qint64 fileSize, qint64 &resumePos);
+
+    //! Get the name of the search kernel used by findStorageHeader().
+    /*!
+      \return "avx2", "sse2" or "scalar"
+    */
+    static QString getKernelName();
+
+private:
+
+    //! Process a storage header found at file position headerPos.
+    ScanResult foundHeader(qint64 headerPos, QDltIndex &index);
+
+    //! The size of the scanned file.
+    qint64 fileSize;
+
+    //! The file position where scanning was started.
+    qint64 startPos;
+
+    //! The start of the message whose length chain is followed.
+    qint64 currentPos;
+
+    //! The expected start of the next message, only valid if synced.
+    qint64 nextPos;
+
+    //! The file position where the search for the next header continues.
+    qint64 searchPos;
+
+    //! The file position where reading must continue after a resync.
+    qint64 resyncPos;
+
+    //! Scanning stops at the first message starting at or behind this position.
+    qint64 limit;
+
+    //! The first message reached behind the limit.
+    qint64 limitPos;
+
+    //! Number of wrong headers found.
+    qint64 errors;
+
+    //! True if the length chain of the current message is followed.
+    bool synced;
+
+    //! True if the message length of the current message is read.
+    bool readingLength;
+
+    //! Number of bytes of the message length already read.
+    int lengthBytes;
+
+    //! The message length read from the standard header.
+    quint16 length;
+
+    //! The last bytes of the previous buffer, needed if a pattern is split between two buffers.
+    char tail[3];
+    int tailSize;
+    qint64 tailPos;
+};
+
+#endif // QDLT_INDEX_SCANNER_H
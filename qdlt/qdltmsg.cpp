@@ -104,44 +104,49 @@ QString QDltMsg::getCtrlReturnTypeString() const
 }
 QString QDltMsg::getTimeString() const
 {
-    char strtime[256];
-    struct tm *time_tm;
-    time_tm = localtime(&time);
-    if(time_tm)
-        strftime(strtime, 256, "%Y/%m/%d %H:%M:%S", time_tm);
-    return QString(strtime);
+    return QDltTimeFormatter::threadInstance().localTime(time);
 }
 
 QString QDltMsg::getGmTimeWithOffsetString(qlonglong offset, bool dst)
 {
-    struct tm *time_tm;
-    time_tm = gmtime(&time);
-
-    /*Reason for adding:
-        tm_mon	months since January	0-11
-        tm_year	years since 1900
-    */
-    QDate date(time_tm->tm_year+1900,time_tm->tm_mon+1,time_tm->tm_mday);
-    QTime time(time_tm->tm_hour,time_tm->tm_min,time_tm->tm_sec);
+    return QDltTimeFormatter::threadInstance().gmTimeWithOffset(time, offset, dst);
+}
 
-    if(!date.isValid() || !time.isValid())
-        return QString("Invalid date");
 
-    QDateTime gmDateTime(date,time,Qt::UTC);
+/* copy data into a buffer, the memory of the buffer is reused if it is large enough */
+static void copyBuffer(QByteArray &buffer, const char *data, int size)
+{
+    if(buffer.capacity() < size)
+        buffer.reserve(size);
+    buffer.resize(size);
+    memcpy(buffer.data(), data, size);
+}
 
-    gmDateTime = gmDateTime.addSecs(offset);
+/* set an id, same as QString(QByteArray(data,4)), the memory of the string is reused for ASCII ids */
+static void copyId(QString &id, const char *data)
+{
+    int length = 0;
 
-    if(dst)
-       gmDateTime = gmDateTime.addSecs(3600);
+    while(length < DLT_ID_SIZE && data[length] != 0)
+    {
+        if((unsigned char) data[length] >= 0x80)
+        {
+            id = QString(QByteArray(data,DLT_ID_SIZE));
+            return;
+        }
+        length++;
+    }
 
-    return gmDateTime.toString("yyyy/MM/dd hh:mm:ss");
+    if(id.capacity() < DLT_ID_SIZE)
+        id.reserve(DLT_ID_SIZE);
+    id.resize(length);
+    QChar *chars = id.data();
+    for(int num = 0; num < length; num++)
+        chars[num] = QLatin1Char(data[num]);
 }
 
-
 bool QDltMsg::setMsg(const QByteArray& buf, bool withStorageHeader)
 {
-    unsigned int offset;
-    QDltArgument argument;
     const DltStorageHeader *storageheader = 0;
     const DltStandardHeader *standardheader = 0;
     const DltExtendedHeader *extendedheader = 0;
@@ -192,7 +197,7 @@ bool QDltMsg::setMsg(const QByteArray& buf, bool withStorageHeader)
     headerSize = headersize;
 
     /* copy header */
-    header = buf.mid(0,headersize);
+    copyBuffer(header, buf.constData(), headersize);
 
     /* load standard header extra parameters and Extended header if used */
     if (extra_size>0)
@@ -230,24 +235,24 @@ bool QDltMsg::setMsg(const QByteArray& buf, bool withStorageHeader)
     /* extract ecu id */
     if ( DLT_IS_HTYP_WEID(standardheader->htyp) )
     {
-        ecuid = QString(QByteArray(headerextra.ecu,4));
+        copyId(ecuid, headerextra.ecu);
     }
     else
     {
         if(storageheader)
-            ecuid = QString(QByteArray(storageheader->ecu,4));
+            copyId(ecuid, storageheader->ecu);
     }
 
     /* extract application id */
     if ((DLT_IS_HTYP_UEH(standardheader->htyp)) && (extendedheader->apid[0]!=0))
     {
-        apid = QString(QByteArray(extendedheader->apid,4));
+        copyId(apid, extendedheader->apid);
     }
 
     /* extract context id */
     if ((DLT_IS_HTYP_UEH(standardheader->htyp)) && (extendedheader->ctid[0]!=0))
     {
-        ctid = QString(QByteArray(extendedheader->ctid,4));
+        copyId(ctid, extendedheader->ctid);
     }
 
     /* extract type */
@@ -318,7 +323,7 @@ bool QDltMsg::setMsg(const QByteArray& buf, bool withStorageHeader)
 
     /* copy payload */
     if(payloadSize>0)
-        payload = buf.mid(headersize,payloadSize);
+        copyBuffer(payload, buf.constData() + headersize, payloadSize);
 
     /* set messageid if non verbose */
     if((mode == DltModeNonVerbose) && payload.size()>=4) {
@@ -344,17 +349,39 @@ bool QDltMsg::setMsg(const QByteArray& buf, bool withStorageHeader)
         ctrlReturnType = *((unsigned char*) &(payload.constData()[4]));
     }
 
-    /* get the arguments of the payload */
+    /* the arguments of the payload are checked now, but decoded on first access */
     if(mode==DltModeVerbose) {
-        offset = 0;
-        arguments.clear();
-        for(int num=0;num<numberOfArguments;num++) {
-            if(argument.setArgument(payload,offset,endianness)==false) {
-                /* There was an error parsing the arguments */
-                return false;
-            }
-            arguments.append(argument);
+        if(!QDltArgument::checkArguments(payload.constData(),payload.size(),numberOfArguments,endianness)) {
+            /* There was an error parsing the arguments */
+            return false;
+        }
+        argumentsDecoded = false;
+    }
+
+    return true;
+}
+
+bool QDltMsg::decodeArguments() const
+{
+    QDltArgument argument;
+    unsigned int offset = 0;
+
+    if(argumentsDecoded)
+        return argumentsValid;
+
+    argumentsDecoded = true;
+    argumentsValid = true;
+
+    /* get the arguments of the payload, the payload is shared, not copied */
+    QByteArray data = payload;
+    arguments.clear();
+    for(int num=0;num<numberOfArguments;num++) {
+        if(argument.setArgument(data,offset,endianness)==false) {
+            /* There was an error parsing the arguments */
+            argumentsValid = false;
+            return false;
         }
+        arguments.append(argument);
     }
 
     return true;
@@ -369,6 +396,9 @@ bool QDltMsg::getMsg(QByteArray &buf,bool withStorageHeader) {
     /* empty return buffer */
     buf.clear();
 
+    /* the payload is generated from the arguments */
+    decodeArguments();
+
     /* prepare payload */
     payload.clear();
     for (int num = 0;num<arguments.size();num++)
@@ -442,9 +472,10 @@ bool QDltMsg::getMsg(QByteArray &buf,bool withStorageHeader) {
 
 void QDltMsg::clear()
 {
-    ecuid.clear();
-    apid.clear();
-    ctid.clear();
+    /* the ids, header and payload keep their memory, so a reused message does not allocate again */
+    ecuid.resize(0);
+    apid.resize(0);
+    ctid.resize(0);
     type = DltTypeUnknown;
     subtype = DltLogUnknown;
     mode = DltModeUnknown;
@@ -459,24 +490,31 @@ void QDltMsg::clear()
     ctrlServiceId = 0;
     ctrlReturnType = 0;
     arguments.clear();
-    payload.clear();
+    argumentsDecoded = true;
+    argumentsValid = true;
+    payload.resize(0);
     payloadSize = 0;
-    header.clear();
+    header.resize(0);
     headerSize = 0;
 }
 
 void QDltMsg::clearArguments()
 {
     arguments.clear();
+    argumentsDecoded = true;
 }
 
 int QDltMsg::sizeArguments() const
 {
+    decodeArguments();
+
     return arguments.size();
 }
 
 bool QDltMsg::getArgument(int index,QDltArgument &argument) const
 {
+      decodeArguments();
+
       if(index<0 || index>=arguments.size())
           return false;
 
@@ -487,6 +525,8 @@ bool QDltMsg::getArgument(int index,QDltArgument &argument) const
 
 void QDltMsg::addArgument(QDltArgument argument, int index)
 {
+    decodeArguments();
+
     if(index == -1)
         arguments.append(argument);
     else
@@ -495,6 +535,8 @@ void QDltMsg::addArgument(QDltArgument argument, int index)
 
 void QDltMsg::removeArgument(int index)
 {
+    decodeArguments();
+
     arguments.removeAt(index);
 }
 
@@ -504,7 +546,7 @@ QString QDltMsg::toStringHeader() const
     QString text;
     text.reserve(1024);
 
-    text += QString("%1.%2").arg(getTimeString()).arg(getMicroseconds(),6,10,QLatin1Char('0'));
+    text += QDltTimeFormatter::threadInstance().localTime(time, microseconds);
     text += QString(" %1.%2").arg(getTimestamp()/10000).arg(getTimestamp()%10000,4,10,QLatin1Char('0'));
     text += QString(" %1").arg(getMessageCounter());
     text += QString(" %1").arg(getEcuid());
@@ -616,7 +658,7 @@ QString QDltMsg::toStringPayload() const
         return text;
     }
 
-    for(int num=0;num<arguments.size();num++) {
+    for(int num=0;num<sizeArguments();num++) {
         if(getArgument(num,argument)) {
             if(num!=0) {
                 text += " ";
@@ -640,7 +682,7 @@ void QDltMsg::genMsg()
     payload.clear();
 
     // Generate payload for all arguments
-    for(int num=0;num<arguments.size();num++) {
+    for(int num=0;num<sizeArguments();num++) {
         if(getArgument(num,argument)) {
             argument.getArgument(payload,true);
         }
@@ -227,7 +227,7 @@ public:
       \sa DltEndiannessDef
       \param _endianness The endianness of the DLT message.
     */
-    void setEndianness(DltEndiannessDef _endianness) { endianness = _endianness; }
+    void setEndianness(DltEndiannessDef _endianness) { decodeArguments(); endianness = _endianness; }
 
     //! Get the text of the endianness of the DLT message.
     /*!
@@ -273,7 +273,7 @@ public:
       DLT Ctrl messages are also in non-verbose mode.
       \param _mode The mode of the DLT message.
     */
-    void setMode(DltModeDef _mode) { mode = _mode; }
+    void setMode(DltModeDef _mode) { decodeArguments(); mode = _mode; }
 
     //! Get the text of the mode (verbose or non-verbose).
     /*!
@@ -297,7 +297,7 @@ public:
       E.g. if a non-verbose message is decoded these two parameters are different.
       \param noargs The number of arguments in the payload.
     */
-    void setNumberOfArguments(unsigned char noargs) { numberOfArguments = noargs; }
+    void setNumberOfArguments(unsigned char noargs) { decodeArguments(); numberOfArguments = noargs; }
 
     //! Get the binary header of the DLT message.
     /*!
@@ -330,7 +330,7 @@ public:
       Be careful with this function, binary data and interpreted data will not be in sync anymore.
       \param data The new payload of the DLT message
     */
-    void setPayload(QByteArray &data) { payload = data; }
+    void setPayload(QByteArray &data) { decodeArguments(); payload = data; }
 
     //! Generate binary header and payload.
     /*!
@@ -381,6 +381,16 @@ public:
     */
     QString getCtrlReturnTypeString() const;
 
+    //! Decode the arguments of a verbose message.
+    /*!
+      The arguments are not decoded by setMsg(), they are decoded from the payload, when they are accessed first.
+      This is done by sizeArguments(), getArgument() and toStringPayload(), so this function is only needed
+      to check if the payload contains valid arguments, which setMsg() already checked. Decoding is done only once.
+      Because the arguments are decoded on access, a message must not be accessed by several threads at the same time.
+      \return True if all arguments were decoded, false if there was an error parsing the arguments.
+    */
+    bool decodeArguments() const;
+
     //! Get argument size.
     /*!
       Get the number of arguments in the argument list.
@@ -424,6 +434,7 @@ public:
       corresponding buffers. If it fails, but at least the header can be read, the payload
       size can be retrieved, which is perhaps wrong.
       This function returns false, if an error in the decoded message was found.
+      The arguments of verbose messages are checked, but decoded later, see decodeArguments().
       \param buf the buffer containing the DLT messages.
       \param withSH message to be parsed contains storage header, default true.
       \return True if the operation was successful, false if there was an error.
@@ -440,6 +451,9 @@ public:
     bool getMsg(QByteArray &buf,bool withStorageHeader = true);
 
     //! Clears all variables of the message.
+    /*!
+      The memory of the ids, header and payload is kept, so setMsg() on a reused message does not allocate again.
+    */
     void clear();
 
     //! Print Header into a string.
@@ -516,8 +530,14 @@ private:
     //! The return type if the message is a ctrl response message.
     unsigned char ctrlReturnType;
 
-    //! List of arguments of the DLT message.
-    QList<QDltArgument> arguments;
+    //! List of arguments of the DLT message, decoded on first access.
+    mutable QList<QDltArgument> arguments;
+
+    //! The arguments were decoded from the payload or set.
+    mutable bool argumentsDecoded;
+
+    //! No error occured while decoding the arguments.
+    mutable bool argumentsValid;
 };
 
 #endif // QDLT_MSG_H
@@ -0,0 +1,221 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltmsgtable.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QtDebug>
+
+#include "qdltmsgtable.h"
+#include "qdltindex.h"
+#include "qdltmsgview.h"
+
+QDltMsgTable::QDltMsgTable()
+{
+}
+
+void QDltMsgTable::clear()
+{
+    ecuid.clear();
+    apid.clear();
+    ctid.clear();
+    type.clear();
+    subtype.clear();
+    time.clear();
+    microseconds.clear();
+    timestamp.clear();
+    messageCounter.clear();
+    messageId.clear();
+}
+
+void QDltMsgTable::reserve(int size)
+{
+    ecuid.reserve(size);
+    apid.reserve(size);
+    ctid.reserve(size);
+    type.reserve(size);
+    subtype.reserve(size);
+    time.reserve(size);
+    microseconds.reserve(size);
+    timestamp.reserve(size);
+    messageCounter.reserve(size);
+    messageId.reserve(size);
+}
+
+void QDltMsgTable::resize(int size)
+{
+    ecuid.resize(size);
+    apid.resize(size);
+    ctid.resize(size);
+    type.resize(size);
+    subtype.resize(size);
+    time.resize(size);
+    microseconds.resize(size);
+    timestamp.resize(size);
+    messageCounter.resize(size);
+    messageId.resize(size);
+}
+
+bool QDltMsgTable::append(const char *data, int size, qint64 available)
+{
+    /* the header fields are read in place, the message can start at any address */
+    QDltMsgView view(data, size);
+
+    /* an incomplete message gets an invalid row, to keep the table in line with the index */
+    /* verbose messages with arguments, which can not be parsed, are rejected by QDltMsg::setMsg() too */
+    if(!view.isHeaderValid() || view.getHeaderSize() + view.getPayloadSize() > available ||
+       (view.isVerbose() && !view.isValid()))
+    {
+        ecuid.append(0);
+        apid.append(0);
+        ctid.append(0);
+        type.append(QDLT_MSG_TABLE_TYPE_INVALID);
+        subtype.append(0);
+        time.append(0);
+        microseconds.append(0);
+        timestamp.append(0);
+        messageCounter.append(0);
+        messageId.append(0);
+        return false;
+    }
+
+    ecuid.append(view.getEcuid());
+    apid.append(view.getApid());
+    ctid.append(view.getCtid());
+    type.append((qint8) view.getType());
+    subtype.append((qint8) view.getSubtype());
+    time.append((quint32) view.getTime());
+    microseconds.append(view.getMicroseconds());
+    timestamp.append(view.getTimestamp());
+    messageCounter.append(view.getMessageCounter());
+    messageId.append(view.getMessageId());
+
+    return true;
+}
+
+QByteArray QDltMsgTable::readRowData(QIODevice &file)
+{
+    QByteArray buf = file.read(QDLT_MSG_TABLE_READ_SIZE);
+
+    /* the arguments of verbose messages are checked, so the whole payload is needed */
+    QDltMsgView view(buf);
+    int msgSize = view.getHeaderSize() + view.getPayloadSize();
+    if(view.isVerbose() && buf.size() < msgSize)
+        buf.append(file.read(msgSize - buf.size()));
+
+    return buf;
+}
+
+bool QDltMsgTable::update(QFile &file, const QDltIndex &index)
+{
+    qint64 fileSize = file.size();
+
+    if(size() > index.size())
+        resize(index.size());
+    if(size() == index.size())
+        return true;
+
+    reserve(index.size());
+
+    /* read the headers from the mapped file, if possible */
+    uchar *data = fileSize > 0 ? file.map(0, fileSize) : 0;
+    if(data)
+    {
+        for(int num = size(); num < index.size(); num++)
+        {
+            qint64 pos = index.at(num);
+            qint64 available = qMax(fileSize - pos, (qint64) 0);
+            append((const char*) data + pos, (int) qMin(available, (qint64) QDLT_MSG_TABLE_MAX_MSG_SIZE), available);
+        }
+        file.unmap(data);
+        return true;
+    }
+
+    /* read the headers with the file position */
+    QByteArray buf;
+    for(int num = size(); num < index.size(); num++)
+    {
+        qint64 pos = index.at(num);
+        if(!file.seek(pos))
+        {
+            resize(num);
+            return false;
+        }
+        buf = readRowData(file);
+        append(buf.constData(), buf.size(), qMax(fileSize - pos, (qint64) 0));
+    }
+
+    return true;
+}
+
+template <class T> static bool saveColumn(QIODevice &device, const QVector<T> &column)
+{
+    qint64 bytes = (qint64) column.size() * sizeof(T);
+    return device.write((const char*) column.constData(), bytes) == bytes;
+}
+
+template <class T> static bool loadColumn(QIODevice &device, QVector<T> &column, int size)
+{
+    qint64 bytes = (qint64) size * sizeof(T);
+    column.resize(size);
+    return device.read((char*) column.data(), bytes) == bytes;
+}
+
+bool QDltMsgTable::save(QIODevice &device) const
+{
+    return saveColumn(device, ecuid) &&
+           saveColumn(device, apid) &&
+           saveColumn(device, ctid) &&
+           saveColumn(device, type) &&
+           saveColumn(device, subtype) &&
+           saveColumn(device, time) &&
+           saveColumn(device, microseconds) &&
+           saveColumn(device, timestamp) &&
+           saveColumn(device, messageCounter) &&
+           saveColumn(device, messageId);
+}
+
+bool QDltMsgTable::load(QIODevice &device, int size)
+{
+    if(loadColumn(device, ecuid, size) &&
+       loadColumn(device, apid, size) &&
+       loadColumn(device, ctid, size) &&
+       loadColumn(device, type, size) &&
+       loadColumn(device, subtype, size) &&
+       loadColumn(device, time, size) &&
+       loadColumn(device, microseconds, size) &&
+       loadColumn(device, timestamp, size) &&
+       loadColumn(device, messageCounter, size) &&
+       loadColumn(device, messageId, size))
+    {
+        return true;
+    }
+
+    clear();
+    return false;
+}
+
+qint64 QDltMsgTable::fileSize(int size)
+{
+    return (qint64) size * (7 * sizeof(quint32) + 3 * sizeof(qint8));
+}
+
+qint64 QDltMsgTable::memoryUsage() const
+{
+    return (qint64) (ecuid.capacity() + apid.capacity() + ctid.capacity() + time.capacity() +
+                     microseconds.capacity() + timestamp.capacity() + messageId.capacity()) * sizeof(quint32) +
+           (qint64) (type.capacity() + subtype.capacity() + messageCounter.capacity()) * sizeof(quint8);
+}
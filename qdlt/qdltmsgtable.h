@@ -0,0 +1,193 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltmsgtable.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_MSG_TABLE_H
+#define QDLT_MSG_TABLE_H
+
+#include <QString>
+#include <QVector>
+#include <QIODevice>
+#include <QFile>
+
+#include "export_rules.h"
+
+class QDltIndex;
+
+/* bytes of a message needed for one row: storage header 16, standard header 4, extra 12, extended header 10, message id 4 */
+#define QDLT_MSG_TABLE_READ_SIZE 46
+
+/* largest message: storage header 16 and the maximum length of the standard header */
+#define QDLT_MSG_TABLE_MAX_MSG_SIZE (16 + 65535)
+
+/* message type of a row of a message, which is incomplete in the log file */
+#define QDLT_MSG_TABLE_TYPE_INVALID -1
+
+//! Header fields of all DLT messages of a log file, stored column by column.
+/*!
+  The table contains one row per message of the index of a log file.
+  Each header field is stored in its own vector, so filters, sorting and statistics,
+  which only need a few header fields, read the fields of all messages without
+  reading and decoding the messages from the log file.
+  ECU, application and context ids are stored as 32 bit values containing the 4 characters
+  of the id in file order, see QDltMsgView::idFromString() and QDltMsgView::idToString().
+  The fields have the same values as the corresponding fields of QDltMsg after QDltMsg::setMsg().
+  Copies of the table share the columns until they are modified.
+*/
+class QDLT_EXPORT QDltMsgTable
+{
+public:
+    //! Constructor.
+    QDltMsgTable();
+
+    //! Get the number of messages.
+    int size() const { return ecuid.size(); }
+
+    //! Check if the table contains no messages.
+    bool isEmpty() const { return ecuid.isEmpty(); }
+
+    //! Remove all messages.
+    void clear();
+
+    //! Reserve space for a number of messages.
+    void reserve(int size);
+
+    //! Remove all messages behind the first messages.
+    /*!
+      \param size The number of messages to keep.
+    */
+    void resize(int size);
+
+    //! Append the header fields of a DLT message with storage header.
+    /*!
+      The payload is only needed for the message id of non verbose messages and
+      to check the arguments of verbose messages.
+      If the message is incomplete in the log file or QDltMsg::setMsg() would reject it,
+      an invalid row is appended, so the table stays in line with the index, see isValid().
+      \param data The message starting with the storage header.
+      \param size The number of bytes in data, at least QDLT_MSG_TABLE_READ_SIZE if the message is not shorter,
+      verbose messages must be contained completely, see readRowData().
+      \param available The number of bytes from the start of the message to the end of the log file.
+      \return true if the message is complete, false if an invalid row was appended.
+    */
+    bool append(const char *data, int size, qint64 available);
+
+    //! Read the data of a message needed by append() from the current file position.
+    /*!
+      These are the first QDLT_MSG_TABLE_READ_SIZE bytes, verbose messages are read completely.
+      \param file The opened log file positioned at the start of the message.
+      \return the data, shorter if the file ends.
+    */
+    static QByteArray readRowData(QIODevice &file);
+
+    //! Append the header fields of all messages of the index, which are not in the table yet.
+    /*!
+      The file is mapped into memory while reading, if mapping fails the headers are read
+      with the file position.
+      \param file The opened log file.
+      \param index The positions of the messages in the log file.
+      \return true if the table contains all messages of the index, false if an error occured.
+    */
+    bool update(QFile &file, const QDltIndex &index);
+
+    //! Check if a message is complete in the log file and QDltMsg::setMsg() would succeed.
+    /*!
+      The other fields of an invalid row are 0.
+    */
+    bool isValid(int index) const { return type.at(index) != QDLT_MSG_TABLE_TYPE_INVALID; }
+
+    //! ECU id of a message.
+    quint32 getEcuId(int index) const { return ecuid.at(index); }
+
+    //! Application id of a message, 0 if the message has no extended header.
+    quint32 getApid(int index) const { return apid.at(index); }
+
+    //! Context id of a message, 0 if the message has no extended header.
+    quint32 getCtid(int index) const { return ctid.at(index); }
+
+    //! Message type of a message, see QDltMsg::DltTypeDef.
+    qint8 getType(int index) const { return type.at(index); }
+
+    //! Message subtype of a message, e.g. the log level.
+    qint8 getSubtype(int index) const { return subtype.at(index); }
+
+    //! Seconds of the storage header of a message.
+    quint32 getTime(int index) const { return time.at(index); }
+
+    //! Microseconds of the storage header of a message.
+    quint32 getMicroseconds(int index) const { return microseconds.at(index); }
+
+    //! Timestamp of a message in 0.1 ms, 0 if the message has no timestamp.
+    quint32 getTimestamp(int index) const { return timestamp.at(index); }
+
+    //! Message counter of a message.
+    quint8 getMessageCounter(int index) const { return messageCounter.at(index); }
+
+    //! Message id of a non verbose message, 0 for verbose messages.
+    quint32 getMessageId(int index) const { return messageId.at(index); }
+
+    //! Get the columns of a field to process all messages at once.
+    const QVector<quint32> &getEcuIds() const { return ecuid; }
+    const QVector<quint32> &getApids() const { return apid; }
+    const QVector<quint32> &getCtids() const { return ctid; }
+    const QVector<qint8> &getTypes() const { return type; }
+    const QVector<qint8> &getSubtypes() const { return subtype; }
+    const QVector<quint32> &getTimes() const { return time; }
+    const QVector<quint32> &getMicroseconds() const { return microseconds; }
+    const QVector<quint32> &getTimestamps() const { return timestamp; }
+    const QVector<quint8> &getMessageCounters() const { return messageCounter; }
+    const QVector<quint32> &getMessageIds() const { return messageId; }
+
+    //! Write the table to a file, column by column.
+    /*!
+      \param device The opened file.
+      \return true if all columns were written, false if an error occured.
+    */
+    bool save(QIODevice &device) const;
+
+    //! Read a table written by save().
+    /*!
+      \param device The opened file, positioned at the start of the table.
+      \param size The number of messages stored in the file.
+      \return true if all columns were read, false if an error occured.
+    */
+    bool load(QIODevice &device, int size);
+
+    //! Get the number of bytes written by save() for a number of messages.
+    static qint64 fileSize(int size);
+
+    //! Get the memory allocated by the table.
+    /*!
+      \return the number of bytes
+    */
+    qint64 memoryUsage() const;
+
+private:
+    QVector<quint32> ecuid;
+    QVector<quint32> apid;
+    QVector<quint32> ctid;
+    QVector<qint8> type;
+    QVector<qint8> subtype;
+    QVector<quint32> time;
+    QVector<quint32> microseconds;
+    QVector<quint32> timestamp;
+    QVector<quint8> messageCounter;
+    QVector<quint32> messageId;
+};
+
+#endif // QDLT_MSG_TABLE_H
@@ -0,0 +1,297 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltmsgview.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QtDebug>
+#include <stddef.h>
+#include <string.h>
+
+#include "qdltmsgview.h"
+#include "qdltmsg.h"
+#include "qdltargument.h"
+
+extern "C"
+{
+#include "dlt_common.h"
+}
+
+QDltMsgView::QDltMsgView()
+{
+    setMsg(0, 0);
+}
+
+QDltMsgView::QDltMsgView(const char *data, int size, bool withStorageHeader)
+{
+    setMsg(data, size, withStorageHeader);
+}
+
+QDltMsgView::QDltMsgView(const QByteArray &buf, bool withStorageHeader)
+{
+    setMsg(buf.constData(), buf.size(), withStorageHeader);
+}
+
+bool QDltMsgView::setMsg(const QByteArray &buf, bool withStorageHeader)
+{
+    return setMsg(buf.constData(), buf.size(), withStorageHeader);
+}
+
+bool QDltMsgView::setMsg(const char *data, int size, bool withStorageHeader)
+{
+    this->data = data;
+    this->size = size;
+    storageHeaderSize = withStorageHeader ? sizeof(DltStorageHeader) : 0;
+    htyp = 0;
+    extendedHeaderOffset = 0;
+    headerSize = 0;
+    payloadSize = 0;
+    headerValid = false;
+    payloadValid = false;
+    argumentsValid = false;
+
+    /* same checks as in QDltMsg::setMsg() */
+    if(!data || size < (int) (storageHeaderSize + sizeof(DltStandardHeader)))
+        return false;
+
+    DltStandardHeader standardheader;
+    memcpy(&standardheader, data + storageHeaderSize, sizeof(DltStandardHeader));
+    htyp = standardheader.htyp;
+
+    extendedHeaderOffset = storageHeaderSize + sizeof(DltStandardHeader) + DLT_STANDARD_HEADER_EXTRA_SIZE(htyp);
+    headerSize = extendedHeaderOffset + (DLT_IS_HTYP_UEH(htyp) ? sizeof(DltExtendedHeader) : 0);
+    if(size < headerSize)
+        return false;
+    headerValid = true;
+
+    int length = DLT_SWAP_16(standardheader.len);
+    if(length >= headerSize - storageHeaderSize)
+        payloadSize = length - (headerSize - storageHeaderSize);
+    payloadValid = size >= headerSize + payloadSize;
+    if(!payloadValid)
+        return false;
+
+    /* the arguments are checked, but not decoded */
+    argumentsValid = !isVerbose() ||
+            QDltArgument::checkArguments(data + headerSize, payloadSize, getNumberOfArguments(),
+                                         isBigEndian() ? QDlt::DltEndiannessBigEndian : QDlt::DltEndiannessLittleEndian);
+
+    return argumentsValid;
+}
+
+QByteArray QDltMsgView::getHeader() const
+{
+    if(!headerValid)
+        return QByteArray();
+
+    return QByteArray::fromRawData(data, headerSize);
+}
+
+QByteArray QDltMsgView::getPayload() const
+{
+    if(!payloadValid)
+        return QByteArray();
+
+    return QByteArray::fromRawData(data + headerSize, payloadSize);
+}
+
+quint32 QDltMsgView::read32(int offset) const
+{
+    quint32 value;
+
+    /* the message can start at any address */
+    memcpy(&value, data + offset, sizeof(value));
+
+    return value;
+}
+
+quint32 QDltMsgView::readId(int offset) const
+{
+    char id[DLT_ID_SIZE];
+
+    /* QDltMsg ends the id string at the first 0 byte */
+    memcpy(id, data + offset, DLT_ID_SIZE);
+    for(int num = 0; num < DLT_ID_SIZE; num++)
+    {
+        if(id[num] == 0)
+        {
+            memset(id + num, 0, DLT_ID_SIZE - num);
+            break;
+        }
+    }
+
+    quint32 value;
+    memcpy(&value, id, sizeof(value));
+
+    return value;
+}
+
+quint32 QDltMsgView::getEcuid() const
+{
+    if(!headerValid)
+        return 0;
+
+    if(DLT_IS_HTYP_WEID(htyp))
+        return readId(storageHeaderSize + sizeof(DltStandardHeader));
+    if(storageHeaderSize)
+        return readId(offsetof(DltStorageHeader, ecu));
+
+    return 0;
+}
+
+quint32 QDltMsgView::getApid() const
+{
+    if(!headerValid || !DLT_IS_HTYP_UEH(htyp))
+        return 0;
+
+    return readId(extendedHeaderOffset + offsetof(DltExtendedHeader, apid));
+}
+
+quint32 QDltMsgView::getCtid() const
+{
+    if(!headerValid || !DLT_IS_HTYP_UEH(htyp))
+        return 0;
+
+    return readId(extendedHeaderOffset + offsetof(DltExtendedHeader, ctid));
+}
+
+int QDltMsgView::getType() const
+{
+    if(!headerValid || !DLT_IS_HTYP_UEH(htyp))
+        return QDltMsg::DltTypeUnknown;
+
+    return DLT_GET_MSIN_MSTP((unsigned char) data[extendedHeaderOffset]);
+}
+
+int QDltMsgView::getSubtype() const
+{
+    if(!headerValid || !DLT_IS_HTYP_UEH(htyp))
+        return QDltMsg::DltLogUnknown;
+
+    return DLT_GET_MSIN_MTIN((unsigned char) data[extendedHeaderOffset]);
+}
+
+bool QDltMsgView::isVerbose() const
+{
+    return headerValid && DLT_IS_HTYP_UEH(htyp) && DLT_IS_MSIN_VERB((unsigned char) data[extendedHeaderOffset]);
+}
+
+bool QDltMsgView::isBigEndian() const
+{
+    return DLT_IS_HTYP_MSBF(htyp);
+}
+
+time_t QDltMsgView::getTime() const
+{
+    if(!headerValid || !storageHeaderSize)
+        return 0;
+
+    return (time_t) read32(offsetof(DltStorageHeader, seconds));
+}
+
+unsigned int QDltMsgView::getMicroseconds() const
+{
+    if(!headerValid || !storageHeaderSize)
+        return 0;
+
+    return read32(offsetof(DltStorageHeader, microseconds));
+}
+
+unsigned int QDltMsgView::getTimestamp() const
+{
+    if(!headerValid || !DLT_IS_HTYP_WTMS(htyp))
+        return 0;
+
+    return DLT_BETOH_32(read32(storageHeaderSize + sizeof(DltStandardHeader)
+                               + (DLT_IS_HTYP_WEID(htyp) ? DLT_SIZE_WEID : 0)
+                               + (DLT_IS_HTYP_WSID(htyp) ? DLT_SIZE_WSID : 0)));
+}
+
+unsigned int QDltMsgView::getSessionid() const
+{
+    if(!headerValid || !DLT_IS_HTYP_WSID(htyp))
+        return 0;
+
+    return DLT_BETOH_32(read32(storageHeaderSize + sizeof(DltStandardHeader)
+                               + (DLT_IS_HTYP_WEID(htyp) ? DLT_SIZE_WEID : 0)));
+}
+
+unsigned char QDltMsgView::getMessageCounter() const
+{
+    if(!headerValid)
+        return 0;
+
+    return (unsigned char) data[storageHeaderSize + offsetof(DltStandardHeader, mcnt)];
+}
+
+int QDltMsgView::getNumberOfArguments() const
+{
+    if(!isVerbose())
+        return 0;
+
+    return (unsigned char) data[extendedHeaderOffset + offsetof(DltExtendedHeader, noar)];
+}
+
+unsigned int QDltMsgView::getMessageId() const
+{
+    /* same byte order as in QDltMsg, only the first bytes of the payload are needed */
+    if(!headerValid || payloadSize < 4 || size < headerSize + 4 || isVerbose())
+        return 0;
+
+    quint32 value = read32(headerSize);
+
+    return DLT_IS_HTYP_MSBF(htyp) ? DLT_SWAP_32(value) : value;
+}
+
+unsigned int QDltMsgView::getCtrlServiceId() const
+{
+    if(!headerValid || payloadSize < 4 || size < headerSize + 4 || getType() != QDltMsg::DltTypeControl)
+        return 0;
+
+    quint32 value = read32(headerSize);
+
+    return DLT_IS_HTYP_MSBF(htyp) ? DLT_SWAP_32(value) : value;
+}
+
+bool QDltMsgView::toMsg(QDltMsg &msg) const
+{
+    /* copied, because QDltMsg may share the header with the buffer */
+    return msg.setMsg(QByteArray(data, data ? size : 0), storageHeaderSize != 0);
+}
+
+quint32 QDltMsgView::idFromString(const QString &id)
+{
+    char data[DLT_ID_SIZE] = {0, 0, 0, 0};
+    quint32 value;
+
+    QByteArray latin = id.toLatin1();
+    memcpy(data, latin.constData(), qMin(latin.size(), DLT_ID_SIZE));
+    memcpy(&value, data, DLT_ID_SIZE);
+
+    return value;
+}
+
+QString QDltMsgView::idToString(quint32 id)
+{
+    char data[DLT_ID_SIZE];
+    int length = 0;
+
+    memcpy(data, &id, DLT_ID_SIZE);
+    while(length < DLT_ID_SIZE && data[length] != 0)
+        length++;
+
+    return QString::fromLatin1(data, length);
+}
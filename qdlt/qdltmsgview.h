@@ -0,0 +1,211 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltmsgview.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_MSG_VIEW_H
+#define QDLT_MSG_VIEW_H
+
+#include <QString>
+#include <QByteArray>
+#include <time.h>
+
+#include "export_rules.h"
+
+class QDltMsg;
+
+//! Read only view of a DLT message, which is not copied.
+/*!
+  The header fields are read directly from the message data, when they are accessed.
+  Nothing is allocated, so checking the header of many messages is much faster than
+  parsing them with QDltMsg::setMsg(). The arguments of verbose messages are checked as by
+  QDltMsg::setMsg(), but not decoded, use toMsg() to get the arguments.
+  ECU, application and context ids are returned as 32 bit values containing the 4 characters
+  of the id in message order, see idFromString() and idToString().
+  The message data must stay valid as long as the view is used.
+*/
+class QDLT_EXPORT QDltMsgView
+{
+public:
+    //! Constructor of an empty view.
+    QDltMsgView();
+
+    //! Constructor of a view of a message.
+    /*!
+      \param data The message data.
+      \param size The size of the data.
+      \param withStorageHeader True if the message starts with a storage header.
+    */
+    QDltMsgView(const char *data, int size, bool withStorageHeader = true);
+
+    //! Constructor of a view of a message.
+    /*!
+      The byte array must not be modified or destroyed while the view is used.
+      \param buf The message data.
+      \param withStorageHeader True if the message starts with a storage header.
+    */
+    explicit QDltMsgView(const QByteArray &buf, bool withStorageHeader = true);
+
+    //! Set the viewed message.
+    /*!
+      \param data The message data.
+      \param size The size of the data.
+      \param withStorageHeader True if the message starts with a storage header.
+      \return true if the message is complete and valid, same as isValid().
+    */
+    bool setMsg(const char *data, int size, bool withStorageHeader = true);
+
+    //! Set the viewed message.
+    /*!
+      \param buf The message data.
+      \param withStorageHeader True if the message starts with a storage header.
+      \return true if the message is complete and valid, same as isValid().
+    */
+    bool setMsg(const QByteArray &buf, bool withStorageHeader = true);
+
+    //! Check if all headers and the payload are contained in the data and QDltMsg::setMsg() would succeed.
+    /*!
+      The arguments of verbose messages must be parsable as in QDltMsg::setMsg().
+    */
+    bool isValid() const { return headerValid && payloadValid && argumentsValid; }
+
+    //! Check if all headers are contained in the data, the header fields can be read.
+    bool isHeaderValid() const { return headerValid; }
+
+    //! Get the size of all headers including the storage header.
+    int getHeaderSize() const { return headerSize; }
+
+    //! Get the size of the payload.
+    int getPayloadSize() const { return payloadSize; }
+
+    //! Get all headers including the storage header, not copied.
+    QByteArray getHeader() const;
+
+    //! Get the payload, not copied.
+    QByteArray getPayload() const;
+
+    //! Get the ECU id, from the standard header if available, else from the storage header.
+    quint32 getEcuid() const;
+
+    //! Get the application id, 0 if the message has no extended header.
+    quint32 getApid() const;
+
+    //! Get the context id, 0 if the message has no extended header.
+    quint32 getCtid() const;
+
+    //! Get the message type, see QDltMsg::DltTypeDef.
+    int getType() const;
+
+    //! Get the message subtype, e.g. the log level.
+    int getSubtype() const;
+
+    //! Check if the message is a verbose message.
+    bool isVerbose() const;
+
+    //! Check if the payload is big endian.
+    bool isBigEndian() const;
+
+    //! Get the seconds of the storage header.
+    time_t getTime() const;
+
+    //! Get the microseconds of the storage header.
+    unsigned int getMicroseconds() const;
+
+    //! Get the timestamp in 0.1 ms, 0 if the message has no timestamp.
+    unsigned int getTimestamp() const;
+
+    //! Get the session id, 0 if the message has no session id.
+    unsigned int getSessionid() const;
+
+    //! Get the message counter.
+    unsigned char getMessageCounter() const;
+
+    //! Get the number of arguments of a verbose message.
+    int getNumberOfArguments() const;
+
+    //! Get the message id of a non verbose message, 0 for verbose messages.
+    /*!
+      Only the first 4 bytes of the payload must be contained in the data.
+    */
+    unsigned int getMessageId() const;
+
+    //! Get the service id of a control message, 0 for other messages.
+    /*!
+      Only the first 4 bytes of the payload must be contained in the data.
+    */
+    unsigned int getCtrlServiceId() const;
+
+    //! Parse the complete message including the arguments.
+    /*!
+      \param msg The message to be filled.
+      \return true if the message was parsed successfully, see QDltMsg::setMsg().
+    */
+    bool toMsg(QDltMsg &msg) const;
+
+    //! Convert an id like the ECU id to its 32 bit value.
+    /*!
+      \param id The id with up to 4 characters.
+      \return the 32 bit value, 0 for an empty id.
+    */
+    static quint32 idFromString(const QString &id);
+
+    //! Convert a 32 bit id value to the id.
+    /*!
+      \param id The 32 bit value.
+      \return the id, empty for 0.
+    */
+    static QString idToString(quint32 id);
+
+private:
+    //! Read a 32 bit value from the message data.
+    quint32 read32(int offset) const;
+
+    //! Read an id from the message data, the bytes after the first 0 byte are set to 0 as in QDltMsg.
+    quint32 readId(int offset) const;
+
+    //! The message data.
+    const char *data;
+
+    //! The size of the message data.
+    int size;
+
+    //! The size of the storage header, 0 if the message has no storage header.
+    int storageHeaderSize;
+
+    //! The header type of the standard header.
+    unsigned char htyp;
+
+    //! The offset of the extended header.
+    int extendedHeaderOffset;
+
+    //! The size of all headers including the storage header.
+    int headerSize;
+
+    //! The size of the payload.
+    int payloadSize;
+
+    //! All headers are contained in the data.
+    bool headerValid;
+
+    //! The payload is contained in the data.
+    bool payloadValid;
+
+    //! The arguments of a verbose message can be parsed, always true for other messages with payload.
+    bool argumentsValid;
+};
+
+#endif // QDLT_MSG_VIEW_H
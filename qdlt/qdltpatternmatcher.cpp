@@ -0,0 +1,264 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltpatternmatcher.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <string.h>
+
+#include "qdltpatternmatcher.h"
+
+/* number of characters with a direct transition in the nodes near the root */
+#define QDLT_PATTERN_MATCHER_ASCII 128
+
+/* nodes up to this depth have a transition table, deeper nodes have few children and follow their edges */
+#define QDLT_PATTERN_MATCHER_DENSE_DEPTH 2
+
+QDltPatternMatcher::QDltPatternMatcher()
+    : count(0)
+{
+}
+
+void QDltPatternMatcher::clear()
+{
+    sensitive.clear();
+    insensitive.clear();
+    sensitiveIds.clear();
+    insensitiveIds.clear();
+    emptyIds.clear();
+    count = 0;
+}
+
+int QDltPatternMatcher::addPattern(const QString &pattern, Qt::CaseSensitivity cs)
+{
+    QHash<QString, int> &ids = (cs == Qt::CaseSensitive) ? sensitiveIds : insensitiveIds;
+
+    QHash<QString, int>::const_iterator it = ids.constFind(pattern);
+    if(it != ids.constEnd())
+        return it.value();
+
+    int id = count++;
+    ids.insert(pattern, id);
+
+    if(pattern.isEmpty())
+    {
+        emptyIds.append(id);
+    }
+    else if(cs == Qt::CaseSensitive)
+    {
+        sensitive.add(pattern, id);
+    }
+    else
+    {
+        QString folded(pattern);
+        for(int num = 0; num < folded.size(); num++)
+            folded[num] = QChar(foldCase(folded.at(num).unicode()));
+        insensitive.add(folded, id);
+    }
+
+    return id;
+}
+
+void QDltPatternMatcher::build()
+{
+    sensitive.build();
+    insensitive.build();
+}
+
+void QDltPatternMatcher::match(const QString &text, QBitArray &matches) const
+{
+    matches.fill(false, count);
+
+    for(int num = 0; num < emptyIds.size(); num++)
+        matches.setBit(emptyIds.at(num));
+
+    if(!sensitive.isEmpty())
+        sensitive.match(text, false, matches);
+    if(!insensitive.isEmpty())
+        insensitive.match(text, true, matches);
+}
+
+ushort QDltPatternMatcher::foldCase(ushort c)
+{
+    if(c < QDLT_PATTERN_MATCHER_ASCII)
+        return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+
+    /* surrogates are compared without folding */
+    return QChar::toCaseFolded(c);
+}
+
+QDltPatternMatcher::Automaton::Automaton()
+{
+    clear();
+}
+
+void QDltPatternMatcher::Automaton::clear()
+{
+    children.clear();
+    edges.clear();
+    fail.clear();
+    dense.clear();
+    asciiTable.clear();
+    output.clear();
+
+    /* the root node */
+    edges.append(QVector<QPair<ushort, int> >());
+    fail.append(0);
+    output.append(QVector<int>());
+}
+
+int QDltPatternMatcher::Automaton::child(int node, ushort c) const
+{
+    return children.value(((quint64) node << 16) | c, -1);
+}
+
+int QDltPatternMatcher::Automaton::nextAscii(int node, ushort c) const
+{
+    /* deep nodes follow their edges and failure links until a node with a table is reached,
+     * the root always has a table */
+    while(dense.at(node) < 0)
+    {
+        const QVector<QPair<ushort, int> > &list = edges.at(node);
+        for(int num = 0; num < list.size(); num++)
+        {
+            if(list.at(num).first == c)
+                return list.at(num).second;
+        }
+        node = fail.at(node);
+    }
+
+    return asciiTable.at(dense.at(node) * QDLT_PATTERN_MATCHER_ASCII + c);
+}
+
+void QDltPatternMatcher::Automaton::add(const QString &pattern, int id)
+{
+    int node = 0;
+
+    for(int num = 0; num < pattern.size(); num++)
+    {
+        ushort c = pattern.at(num).unicode();
+        int next = child(node, c);
+        if(next < 0)
+        {
+            next = fail.size();
+            edges.append(QVector<QPair<ushort, int> >());
+            fail.append(0);
+            output.append(QVector<int>());
+            edges[node].append(qMakePair(c, next));
+            children.insert(((quint64) node << 16) | c, next);
+        }
+        node = next;
+    }
+
+    output[node].append(id);
+}
+
+void QDltPatternMatcher::Automaton::build()
+{
+    int nodes = fail.size();
+    QVector<int> queue;
+    QVector<int> depth(nodes, 0);
+
+    queue.reserve(nodes);
+    dense.fill(-1, nodes);
+    asciiTable.clear();
+
+    /* the root has a table with its own children */
+    dense[0] = 0;
+    asciiTable.fill(0, QDLT_PATTERN_MATCHER_ASCII);
+
+    /* the nodes are visited by depth, the failure link of a node is always visited before the node */
+    for(int num = 0; num < edges[0].size(); num++)
+    {
+        fail[edges[0][num].second] = 0;
+        depth[edges[0][num].second] = 1;
+        queue.append(edges[0][num].second);
+        if(edges[0][num].first < QDLT_PATTERN_MATCHER_ASCII)
+            asciiTable[edges[0][num].first] = edges[0][num].second;
+    }
+
+    for(int pos = 0; pos < queue.size(); pos++)
+    {
+        int node = queue.at(pos);
+
+        /* patterns ending at the failure link end here too */
+        output[node] += output[fail[node]];
+
+        /* ASCII transitions without a trie edge continue from the failure link,
+         * which is less deep and has a table too */
+        if(depth[node] <= QDLT_PATTERN_MATCHER_DENSE_DEPTH)
+        {
+            int row = asciiTable.size() / QDLT_PATTERN_MATCHER_ASCII;
+            dense[node] = row;
+            asciiTable.resize((row + 1) * QDLT_PATTERN_MATCHER_ASCII);
+            memcpy(asciiTable.data() + row * QDLT_PATTERN_MATCHER_ASCII,
+                   asciiTable.constData() + dense[fail[node]] * QDLT_PATTERN_MATCHER_ASCII,
+                   QDLT_PATTERN_MATCHER_ASCII * sizeof(int));
+        }
+
+        for(int num = 0; num < edges[node].size(); num++)
+        {
+            ushort c = edges[node][num].first;
+            int next = edges[node][num].second;
+
+            int link = fail[node];
+            while(link > 0 && child(link, c) < 0)
+                link = fail[link];
+            int target = child(link, c);
+            fail[next] = (target >= 0 && target != next) ? target : 0;
+            depth[next] = depth[node] + 1;
+
+            if(dense[node] >= 0 && c < QDLT_PATTERN_MATCHER_ASCII)
+                asciiTable[dense[node] * QDLT_PATTERN_MATCHER_ASCII + c] = next;
+            queue.append(next);
+        }
+    }
+
+    asciiTable.squeeze();
+}
+
+void QDltPatternMatcher::Automaton::match(const QString &text, bool caseFold, QBitArray &matches) const
+{
+    const QChar *data = text.constData();
+    int size = text.size();
+    int node = 0;
+
+    for(int num = 0; num < size; num++)
+    {
+        ushort c = data[num].unicode();
+        if(caseFold)
+            c = foldCase(c);
+
+        if(c < QDLT_PATTERN_MATCHER_ASCII)
+        {
+            node = nextAscii(node, c);
+        }
+        else
+        {
+            int next = child(node, c);
+            while(next < 0 && node > 0)
+            {
+                node = fail.at(node);
+                next = child(node, c);
+            }
+            node = next >= 0 ? next : 0;
+        }
+
+        const QVector<int> &ids = output.at(node);
+        for(int id = 0; id < ids.size(); id++)
+            matches.setBit(ids.at(id));
+    }
+}
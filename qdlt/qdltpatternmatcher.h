@@ -0,0 +1,114 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltpatternmatcher.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_PATTERN_MATCHER_H
+#define QDLT_PATTERN_MATCHER_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QBitArray>
+
+#include "export_rules.h"
+
+//! Search many literal patterns in a text at once.
+/*!
+  All patterns are compiled into Aho-Corasick automatons, one for case sensitive and one for
+  case insensitive patterns. A text is scanned once by each automaton and all patterns
+  contained in the text are reported, so the time to match a text hardly depends on the
+  number of patterns. The result for each pattern is the same as QString::contains().
+  Matching can be done from several threads at the same time, after build() was called.
+*/
+class QDLT_EXPORT QDltPatternMatcher
+{
+public:
+    //! Constructor of an empty matcher.
+    QDltPatternMatcher();
+
+    //! Remove all patterns.
+    void clear();
+
+    //! Add a pattern, the same pattern is only added once.
+    /*!
+      \param pattern The literal pattern.
+      \param cs The case sensitivity of the pattern.
+      \return The id of the pattern, used as bit in the result of match().
+    */
+    int addPattern(const QString &pattern, Qt::CaseSensitivity cs);
+
+    //! Build the automatons, must be called after all patterns are added.
+    void build();
+
+    //! Get the number of patterns.
+    int size() const { return count; }
+
+    //! Find all patterns contained in a text.
+    /*!
+      \param text The text to be searched.
+      \param matches Set to size() bits, the bit of each pattern contained in the text is set.
+    */
+    void match(const QString &text, QBitArray &matches) const;
+
+private:
+    //! Aho-Corasick automaton of patterns with the same case sensitivity.
+    class Automaton
+    {
+    public:
+        Automaton();
+
+        void clear();
+
+        //! Add a pattern to the trie.
+        void add(const QString &pattern, int id);
+
+        //! Create failure links and transitions.
+        void build();
+
+        //! Scan a text and set the bits of all contained patterns.
+        void match(const QString &text, bool caseFold, QBitArray &matches) const;
+
+        bool isEmpty() const { return fail.size() <= 1; }
+
+    private:
+        //! Get the child of a node in the trie, -1 if there is no child for the character.
+        int child(int node, ushort c) const;
+
+        //! Get the next node for an ASCII character.
+        int nextAscii(int node, ushort c) const;
+
+        QHash<quint64, int> children;                   //!< trie edges, key is node and character
+        QVector<QVector<QPair<ushort, int> > > edges;   //!< trie edges of each node
+        QVector<int> fail;                              //!< failure link of each node
+        QVector<int> dense;                             //!< row of each node in asciiTable, -1 for deep nodes
+        QVector<int> asciiTable;                        //!< next node for each ASCII character, for the nodes near the root
+        QVector<QVector<int> > output;                  //!< ids of the patterns ending at each node
+    };
+
+    //! Fold the case of a character like QString::contains() with Qt::CaseInsensitive.
+    static ushort foldCase(ushort c);
+
+    Automaton sensitive;
+    Automaton insensitive;
+    QHash<QString, int> sensitiveIds;
+    QHash<QString, int> insensitiveIds;
+    QVector<int> emptyIds;                              //!< empty patterns are contained in every text
+    int count;
+};
+
+#endif // QDLT_PATTERN_MATCHER_H
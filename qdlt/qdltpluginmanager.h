@@ -55,6 +55,8 @@ public:
     //! Implementation of QDltMessageDecoder's pure virtual method.
     //! Decode message by decoding through all loaded an activated decoder plugins.
     /*!
+      The decoder plugins are called with the plugin list locked, so they are never called
+      by two threads at the same time.
       \param msg The message to be decoded.
       \param triggeredByUser Whether decode operation was triggered by the user or not
     */
@@ -73,6 +73,7 @@ QDltSettingsManager::QDltSettingsManager()
     }
 
     settings = new QSettings(dir.absolutePath()+"/config.ini", QSettings::IniFormat);
+    publishSnapshot();
 }
 
 QDltSettingsManager::~QDltSettingsManager()
@@ -80,9 +81,27 @@ QDltSettingsManager::~QDltSettingsManager()
     delete settings;
 }
 
+void QDltSettingsManager::publishSnapshot()
+{
+    /* settings are changed in the GUI thread only, readers may still use older snapshots,
+     * the previous snapshot is deleted when the last reader releases it */
+    QSharedPointer<const QDltSettingsSnapshot> next(new QDltSettingsSnapshot(*settings));
+
+    QMutexLocker locker(&snapshotMutex);
+    currentSnapshot.swap(next);
+}
+
+QSharedPointer<const QDltSettingsSnapshot> QDltSettingsManager::snapshot() const
+{
+    QMutexLocker locker(&snapshotMutex);
+    return currentSnapshot;
+}
+
 void QDltSettingsManager::setValue(const QString &key, const QVariant &value)
 {
     settings->setValue(key, value);
+    if(QDltSettingsSnapshot::contains(key))
+        publishSnapshot();
 }
 
 QVariant QDltSettingsManager::value(const QString &key, const QVariant &defaultValue) const
@@ -93,6 +112,7 @@ QVariant QDltSettingsManager::value(const QString &key, const QVariant &defaultV
 void QDltSettingsManager::clear()
 {
     settings->clear();
+    publishSnapshot();
 }
 
 QString QDltSettingsManager::fileName() const
@@ -178,6 +198,7 @@ void QDltSettingsManager::writeSettings()
     settings->setValue("startup/pluginsAutoloadPath",pluginsAutoloadPath);
     settings->setValue("startup/pluginsAutoloadPathName",pluginsAutoloadPathName);
     settings->setValue("startup/filterCache",filterCache);
+    settings->setValue("startup/htmlView",htmlView);
     settings->setValue("startup/autoConnect",autoConnect);
     settings->setValue("startup/autoScroll",autoScroll);
     settings->setValue("startup/autoMarkFatalError",autoMarkFatalError);
@@ -232,6 +253,8 @@ void QDltSettingsManager::writeSettings()
     for(int i = 0; i < pluginExecutionPrio.count(); ++i) {
         settings->setValue(QStringLiteral("plugin/default_prio/%1").arg(i), pluginExecutionPrio[i]);
     }
+
+    publishSnapshot();
 }
 
 void QDltSettingsManager::readSettingsLocal(QXmlStreamReader &xml)
@@ -426,6 +449,7 @@ void QDltSettingsManager::readSettings()
     pluginsAutoloadPath = settings->value("startup/pluginsAutoloadPath",0).toInt();
     pluginsAutoloadPathName = settings->value("startup/pluginsAutoloadPathName",QString("")).toString();
     filterCache = settings->value("startup/filterCache",1).toInt();
+    htmlView = settings->value("startup/htmlView",0).toInt();
     autoConnect = settings->value("startup/autoConnect",0).toInt();
     autoScroll = settings->value("startup/autoScroll",1).toInt();
     autoMarkFatalError = settings->value("startup/autoMarkFatalError",0).toInt();
@@ -484,3 +508,25 @@ void QDltSettingsManager::readSettings()
     }
 }
 
+QDltSettingsSnapshot::QDltSettingsSnapshot(const QSettings &settings)
+{
+    /* same defaults as used before the snapshot was read */
+    m_pluginsEnabled = settings.value("startup/pluginsEnabled", true).toBool();
+    m_filtersEnabled = settings.value("startup/filtersEnabled", true).toBool();
+    m_sortByTimeEnabled = settings.value("startup/sortByTimeEnabled", false).toBool();
+    m_sortByTimestampEnabled = settings.value("startup/sortByTimestampEnabled", false).toBool();
+    m_showMsgId = settings.value("startup/showMsgId", true).toBool();
+    m_msgIdFormat = settings.value("startup/msgIdFormat", "0x%x").toString();
+    m_searchResultColor = QColor(settings.value("other/searchResultColor", QString("#00AAFF")).toString());
+}
+
+bool QDltSettingsSnapshot::contains(const QString &key)
+{
+    return key == QLatin1String("startup/pluginsEnabled") ||
+           key == QLatin1String("startup/filtersEnabled") ||
+           key == QLatin1String("startup/sortByTimeEnabled") ||
+           key == QLatin1String("startup/sortByTimestampEnabled") ||
+           key == QLatin1String("startup/showMsgId") ||
+           key == QLatin1String("startup/msgIdFormat") ||
+           key == QLatin1String("other/searchResultColor");
+}
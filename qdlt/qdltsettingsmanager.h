@@ -26,11 +26,60 @@
 #include <qsettings.h>
 #include <QXmlStreamWriter>
 #include <QXmlStreamReader>
+#include <QSharedPointer>
+#include <QMutex>
 
 #include "export_rules.h"
 
 #define DEFAULT_REFRESH_RATE 20
 
+//! Typed copy of the settings, which are read for each message or table cell.
+/*!
+  The snapshot is never changed after it was created, a new snapshot is published
+  by QDltSettingsManager when one of the settings is changed.
+  Reading its values needs no QSettings lookup and no lock, also in other threads.
+  A snapshot is deleted when the last user releases it.
+*/
+class QDLT_EXPORT QDltSettingsSnapshot
+{
+public:
+    //! Read the settings.
+    explicit QDltSettingsSnapshot(const QSettings &settings);
+
+    //! Decoder plugins are enabled, "startup/pluginsEnabled".
+    bool pluginsEnabled() const { return m_pluginsEnabled; }
+
+    //! Filters are enabled, "startup/filtersEnabled".
+    bool filtersEnabled() const { return m_filtersEnabled; }
+
+    //! Sorting by time is enabled, "startup/sortByTimeEnabled".
+    bool sortByTimeEnabled() const { return m_sortByTimeEnabled; }
+
+    //! Sorting by timestamp is enabled, "startup/sortByTimestampEnabled".
+    bool sortByTimestampEnabled() const { return m_sortByTimestampEnabled; }
+
+    //! The message id of non verbose messages is shown, "startup/showMsgId".
+    bool showMsgId() const { return m_showMsgId; }
+
+    //! Format of the message id, "startup/msgIdFormat".
+    QString msgIdFormat() const { return m_msgIdFormat; }
+
+    //! Background color of search results, "other/searchResultColor".
+    QColor searchResultColor() const { return m_searchResultColor; }
+
+    //! Check if a changed setting is contained in the snapshot.
+    static bool contains(const QString &key);
+
+private:
+    bool m_pluginsEnabled;
+    bool m_filtersEnabled;
+    bool m_sortByTimeEnabled;
+    bool m_sortByTimestampEnabled;
+    bool m_showMsgId;
+    QString m_msgIdFormat;
+    QColor m_searchResultColor;
+};
+
 class QDLT_EXPORT QDltSettingsManager
 {
 // Singleton pattern
@@ -49,6 +98,15 @@ private:
     static QDltSettingsManager *m_instance;
     QSettings *settings;
 
+    //! Create a new snapshot of the settings and publish it.
+    void publishSnapshot();
+
+    //! The latest snapshot, older snapshots are deleted when their last user releases them.
+    QSharedPointer<const QDltSettingsSnapshot> currentSnapshot;
+
+    //! Protects currentSnapshot while it is replaced.
+    mutable QMutex snapshotMutex;
+
 // QSettings delegates
 public:
     void setValue(const QString &key, const QVariant &value);
@@ -56,6 +114,13 @@ public:
     void clear();
     QString fileName() const;
 
+    //! Get the latest snapshot of the frequently read settings.
+    /*!
+      The snapshot stays valid as long as the returned pointer is kept, it can be used in any thread.
+      Settings changed after the call are only contained in later snapshots.
+    */
+    QSharedPointer<const QDltSettingsSnapshot> snapshot() const;
+
     void writeSettings();
     void readSettings();
 
@@ -80,6 +145,7 @@ public:
     int pluginsAutoloadPath; // local setting
     QString pluginsAutoloadPathName; // local setting
     int filterCache; // local setting
+    int htmlView; // local setting
     QByteArray geometry; // local setting
     QByteArray windowState; // local setting
     int RefreshRate; // local setting
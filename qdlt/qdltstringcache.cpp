@@ -0,0 +1,162 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltstringcache.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QtDebug>
+
+#include "qdltstringcache.h"
+#include "qdltmsg.h"
+
+/* estimated memory used by a cached string besides its characters */
+#define QDLT_STRING_CACHE_ENTRY_OVERHEAD 64
+
+QDltStringCache::QDltStringCache(int maxMemory)
+    : cache(maxMemory), state(0), hits(0), misses(0)
+{
+}
+
+void QDltStringCache::setState(quint64 state)
+{
+    QMutexLocker locker(&mutex);
+
+    if(this->state == state)
+        return;
+
+    this->state = state;
+    cache.clear();
+}
+
+quint64 QDltStringCache::getState() const
+{
+    QMutexLocker locker(&mutex);
+
+    return state;
+}
+
+bool QDltStringCache::find(qint64 index, Part part, QString &text)
+{
+    QMutexLocker locker(&mutex);
+
+    QString *cached = cache.object(key(index, part));
+    if(!cached)
+    {
+        misses++;
+        return false;
+    }
+
+    hits++;
+    text = *cached;
+    return true;
+}
+
+void QDltStringCache::insert(qint64 index, Part part, const QString &text)
+{
+    int cost = text.size() * (int) sizeof(QChar) + QDLT_STRING_CACHE_ENTRY_OVERHEAD;
+
+    QMutexLocker locker(&mutex);
+
+    /* the string is shared, not copied */
+    cache.insert(key(index, part), new QString(text), cost);
+}
+
+QString QDltStringCache::header(qint64 index, const QDltMsg &msg)
+{
+    QString text;
+
+    if(index < 0)
+        return msg.toStringHeader();
+
+    if(!find(index, Header, text))
+    {
+        text = msg.toStringHeader();
+        insert(index, Header, text);
+    }
+
+    return text;
+}
+
+QString QDltStringCache::payload(qint64 index, const QDltMsg &msg)
+{
+    QString text;
+
+    if(index < 0)
+        return msg.toStringPayload();
+
+    if(!find(index, Payload, text))
+    {
+        text = msg.toStringPayload();
+        insert(index, Payload, text);
+    }
+
+    return text;
+}
+
+void QDltStringCache::clear()
+{
+    QMutexLocker locker(&mutex);
+
+    cache.clear();
+}
+
+void QDltStringCache::setMaxMemory(int maxMemory)
+{
+    QMutexLocker locker(&mutex);
+
+    cache.setMaxCost(maxMemory);
+}
+
+qint64 QDltStringCache::getHits() const
+{
+    QMutexLocker locker(&mutex);
+
+    return hits;
+}
+
+qint64 QDltStringCache::getMisses() const
+{
+    QMutexLocker locker(&mutex);
+
+    return misses;
+}
+
+int QDltStringCache::memoryUsage() const
+{
+    QMutexLocker locker(&mutex);
+
+    return cache.totalCost();
+}
+
+int QDltStringCache::count() const
+{
+    QMutexLocker locker(&mutex);
+
+    return cache.count();
+}
+
+QString QDltStringCache::statistics() const
+{
+    QMutexLocker locker(&mutex);
+
+    qint64 lookups = hits + misses;
+
+    return QString("String cache: %1 strings, %2 KB, hit rate %3 % of %4 lookups")
+            .arg(cache.count())
+            .arg(cache.totalCost() / 1024)
+            .arg(lookups > 0 ? 100.0 * hits / lookups : 0.0, 0, 'f', 1)
+            .arg(lookups);
+}
@@ -0,0 +1,133 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdltstringcache.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_STRING_CACHE_H
+#define QDLT_STRING_CACHE_H
+
+#include <QString>
+#include <QCache>
+#include <QMutex>
+
+#include "export_rules.h"
+
+class QDltMsg;
+
+/* default memory used by the rendered strings of one file */
+#define QDLT_STRING_CACHE_MAX_MEMORY (64*1024*1024)
+
+//! Cache of the header and payload strings of DLT messages.
+/*!
+  Rendering a message with QDltMsg::toStringHeader() and QDltMsg::toStringPayload() is expensive,
+  but filters, the message table and the search render the same messages again and again.
+  The strings are cached by the index of the message in the log file. The memory used by the cache is
+  limited, the least recently used strings are removed first.
+  The strings depend on the decoder plugins and the time settings. These are summarized in a state value,
+  see setState(), all strings are removed when the state changes. The users of a cache must decode the
+  messages in the same way, e.g. with the decoder plugins only if plugins are enabled. If a plugin
+  configuration is reloaded, the strings must be removed with clear().
+  All functions can be called from several threads at the same time.
+*/
+class QDLT_EXPORT QDltStringCache
+{
+public:
+    //! The part of the message rendered to a string.
+    typedef enum { Header = 0, Payload } Part;
+
+    //! Constructor.
+    /*!
+      \param maxMemory The maximum memory used by the strings in bytes.
+    */
+    QDltStringCache(int maxMemory = QDLT_STRING_CACHE_MAX_MEMORY);
+
+    //! Set the state of decoder plugins and time settings the strings are rendered with.
+    /*!
+      All strings are removed, if the state is different from the current state.
+      \param state Any value, which changes when decoder plugins or time settings change.
+    */
+    void setState(quint64 state);
+
+    //! Get the state set by setState().
+    quint64 getState() const;
+
+    //! Get a cached string.
+    /*!
+      \param index The index of the message in the log file.
+      \param part The header or payload string.
+      \param text The cached string.
+      \return true if the string was found.
+    */
+    bool find(qint64 index, Part part, QString &text);
+
+    //! Add a string to the cache.
+    /*!
+      \param index The index of the message in the log file.
+      \param part The header or payload string.
+      \param text The rendered string.
+    */
+    void insert(qint64 index, Part part, const QString &text);
+
+    //! Get the header string of a message, rendered only if it is not cached.
+    /*!
+      \param index The index of the message in the log file, the string is not cached if negative.
+      \param msg The parsed and decoded message.
+      \return The same string as QDltMsg::toStringHeader().
+    */
+    QString header(qint64 index, const QDltMsg &msg);
+
+    //! Get the payload string of a message, rendered only if it is not cached.
+    /*!
+      \param index The index of the message in the log file, the string is not cached if negative.
+      \param msg The parsed and decoded message.
+      \return The same string as QDltMsg::toStringPayload().
+    */
+    QString payload(qint64 index, const QDltMsg &msg);
+
+    //! Remove all strings, e.g. if the messages of the log file changed.
+    void clear();
+
+    //! Set the maximum memory used by the strings.
+    void setMaxMemory(int maxMemory);
+
+    //! Get the number of lookups, which found a string.
+    qint64 getHits() const;
+
+    //! Get the number of lookups, which did not find a string.
+    qint64 getMisses() const;
+
+    //! Get the memory used by the cached strings in bytes.
+    int memoryUsage() const;
+
+    //! Get the number of cached strings.
+    int count() const;
+
+    //! Get hit rate, memory usage and number of strings as text for the log.
+    QString statistics() const;
+
+private:
+    //! The key of a string in the cache.
+    static qint64 key(qint64 index, Part part) { return index * 2 + part; }
+
+    mutable QMutex mutex;
+    QCache<qint64, QString> cache;
+    quint64 state;
+    qint64 hits;
+    qint64 misses;
+};
+
+#endif // QDLT_STRING_CACHE_H
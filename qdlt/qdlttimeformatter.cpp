@@ -0,0 +1,173 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdlttimeformatter.cpp
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#include <QThreadStorage>
+#include <string.h>
+
+#include "qdlttimeformatter.h"
+
+/* write a number with leading zeros */
+static inline void writeDigits(QChar *out, unsigned int value, int digits)
+{
+    for(int num = digits - 1; num >= 0; num--)
+    {
+        out[num] = QLatin1Char('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/* convert the days since 1970 to year, month and day of the gregorian calendar */
+static void civilFromDays(qint64 days, int &year, int &month, int &day)
+{
+    days += 719468;
+    qint64 era = (days >= 0 ? days : days - 146096) / 146097;
+    qint64 dayOfEra = days - era * 146097;
+    qint64 yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    qint64 dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    qint64 monthIndex = (5 * dayOfYear + 2) / 153;
+
+    day = (int) (dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    month = (int) (monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    year = (int) (yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+QDltTimeFormatter::QDltTimeFormatter()
+{
+}
+
+QString QDltTimeFormatter::localTime(time_t time)
+{
+    if(!local.valid || time < local.minute || time >= local.minute + 60)
+    {
+        struct tm time_tm;
+
+        /* localtime() of the windows runtime uses a buffer per thread */
+#ifdef Q_OS_WIN
+        struct tm *result = localtime(&time);
+        if(!result)
+            return QString();
+        time_tm = *result;
+#else
+        if(!localtime_r(&time, &time_tm))
+            return QString();
+#endif
+
+        /* a leap second does not fit into the cached minute */
+        if(time_tm.tm_sec > 59)
+        {
+            char strtime[256];
+            strftime(strtime, 256, "%Y/%m/%d %H:%M:%S", &time_tm);
+            return QString(strtime);
+        }
+
+        /* time zones change their offset at full minutes, so all seconds of the minute have the same prefix */
+        setMinute(local, (qint64) time - time_tm.tm_sec, time_tm.tm_year + 1900, time_tm.tm_mon + 1,
+                  time_tm.tm_mday, time_tm.tm_hour, time_tm.tm_min);
+    }
+
+    return format(local, time);
+}
+
+QString QDltTimeFormatter::localTime(time_t time, unsigned int microseconds)
+{
+    return appendMicroseconds(localTime(time), microseconds);
+}
+
+QString QDltTimeFormatter::gmTimeWithOffset(time_t time, qlonglong offset, bool dst)
+{
+    qint64 shifted = (qint64) time + offset + (dst ? 3600 : 0);
+
+    if(!gm.valid || shifted < gm.minute || shifted >= gm.minute + 60)
+    {
+        qint64 days = (shifted >= 0 ? shifted : shifted - 86399) / 86400;
+        int secondOfDay = (int) (shifted - days * 86400);
+        int year, month, day;
+
+        civilFromDays(days, year, month, day);
+        if(year < 0 || year > 9999)
+            return QString("Invalid date");
+
+        setMinute(gm, shifted - secondOfDay % 60, year, month, day, secondOfDay / 3600, secondOfDay / 60 % 60);
+    }
+
+    return format(gm, shifted);
+}
+
+QString QDltTimeFormatter::gmTimeWithOffset(time_t time, unsigned int microseconds, qlonglong offset, bool dst)
+{
+    return appendMicroseconds(gmTimeWithOffset(time, offset, dst), microseconds);
+}
+
+QDltTimeFormatter &QDltTimeFormatter::threadInstance()
+{
+    static QThreadStorage<QDltTimeFormatter> formatters;
+
+    return formatters.localData();
+}
+
+void QDltTimeFormatter::setMinute(Entry &entry, qint64 minute, int year, int month, int day, int hour, int min)
+{
+    /* "yyyy/MM/dd hh:mm:" */
+    entry.prefix = QString(17, Qt::Uninitialized);
+    QChar *out = entry.prefix.data();
+    writeDigits(out, year, 4);
+    out[4] = QLatin1Char('/');
+    writeDigits(out + 5, month, 2);
+    out[7] = QLatin1Char('/');
+    writeDigits(out + 8, day, 2);
+    out[10] = QLatin1Char(' ');
+    writeDigits(out + 11, hour, 2);
+    out[13] = QLatin1Char(':');
+    writeDigits(out + 14, min, 2);
+    out[16] = QLatin1Char(':');
+
+    entry.minute = minute;
+    entry.text.clear();
+    entry.valid = true;
+}
+
+const QString &QDltTimeFormatter::format(Entry &entry, qint64 second)
+{
+    /* the same second is returned without formatting, the string is shared */
+    if(entry.text.isEmpty() || entry.second != second)
+    {
+        entry.text = QString(19, Qt::Uninitialized);
+        QChar *out = entry.text.data();
+        memcpy(out, entry.prefix.constData(), 17 * sizeof(QChar));
+        writeDigits(out + 17, (unsigned int) (second - entry.minute), 2);
+        entry.second = second;
+    }
+
+    return entry.text;
+}
+
+QString QDltTimeFormatter::appendMicroseconds(const QString &text, unsigned int microseconds)
+{
+    /* same as QString("%1.%2").arg(text).arg(microseconds,6,10,QLatin1Char('0')) */
+    if(microseconds > 999999)
+        return QString("%1.%2").arg(text).arg(microseconds);
+
+    QString result(text.size() + 7, Qt::Uninitialized);
+    QChar *out = result.data();
+    memcpy(out, text.constData(), text.size() * sizeof(QChar));
+    out[text.size()] = QLatin1Char('.');
+    writeDigits(out + text.size() + 1, microseconds, 6);
+
+    return result;
+}
@@ -0,0 +1,107 @@
+/**
+ * @licence app begin@
+ * Copyright (C) 2011-2012  BMW AG
+ *
+ * This file is part of COVESA Project Dlt Viewer.
+ *
+ * Contributions are licensed to the COVESA Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * \file qdlttimeformatter.h
+ * For further information see http://www.covesa.global/.
+ * @licence end@
+ */
+
+#ifndef QDLT_TIME_FORMATTER_H
+#define QDLT_TIME_FORMATTER_H
+
+#include <QString>
+#include <time.h>
+
+#include "export_rules.h"
+
+//! Formatter of the storage header time of DLT messages.
+/*!
+  Formats the time as "yyyy/MM/dd hh:mm:ss", optionally followed by the microseconds,
+  in local time or in UTC with an offset, like QDltMsg::getTimeString() and
+  QDltMsg::getGmTimeWithOffsetString().
+  Consecutive messages are mostly logged in the same second or minute, so the last formatted
+  date and time is reused and only the seconds and microseconds are formatted again.
+  A formatter must only be used by one thread, use threadInstance() to get the formatter of the current thread.
+*/
+class QDLT_EXPORT QDltTimeFormatter
+{
+public:
+    //! Constructor.
+    QDltTimeFormatter();
+
+    //! Format a time in local time.
+    /*!
+      \param time The seconds since 1970.
+      \return The time as "yyyy/MM/dd hh:mm:ss", empty if the time cannot be converted.
+    */
+    QString localTime(time_t time);
+
+    //! Format a time in local time with microseconds.
+    /*!
+      \param time The seconds since 1970.
+      \param microseconds The microseconds.
+      \return The time as "yyyy/MM/dd hh:mm:ss.uuuuuu".
+    */
+    QString localTime(time_t time, unsigned int microseconds);
+
+    //! Format a time in UTC with an offset.
+    /*!
+      \param time The seconds since 1970.
+      \param offset The offset to UTC in seconds.
+      \param dst True if one hour is added for daylight saving time.
+      \return The time as "yyyy/MM/dd hh:mm:ss".
+    */
+    QString gmTimeWithOffset(time_t time, qlonglong offset, bool dst);
+
+    //! Format a time in UTC with an offset and microseconds.
+    /*!
+      \param time The seconds since 1970.
+      \param microseconds The microseconds.
+      \param offset The offset to UTC in seconds.
+      \param dst True if one hour is added for daylight saving time.
+      \return The time as "yyyy/MM/dd hh:mm:ss.uuuuuu".
+    */
+    QString gmTimeWithOffset(time_t time, unsigned int microseconds, qlonglong offset, bool dst);
+
+    //! Get the formatter of the current thread.
+    static QDltTimeFormatter &threadInstance();
+
+private:
+    //! The last formatted time of one time zone.
+    class Entry
+    {
+    public:
+        Entry() : valid(false), minute(0), second(0) {}
+
+        bool valid;        //!< prefix and text contain a formatted time
+        qint64 minute;     //!< first second of the minute in prefix
+        qint64 second;     //!< second in text
+        QString prefix;    //!< "yyyy/MM/dd hh:mm:" of minute
+        QString text;      //!< "yyyy/MM/dd hh:mm:ss" of second
+    };
+
+    //! Set the minute prefix of an entry.
+    static void setMinute(Entry &entry, qint64 minute, int year, int month, int day, int hour, int min);
+
+    //! Get the formatted time of a second in the minute of an entry.
+    static const QString &format(Entry &entry, qint64 second);
+
+    //! Append the microseconds to a formatted time.
+    static QString appendMicroseconds(const QString &text, unsigned int microseconds);
+
+    Entry local;
+    Entry gm;
+};
+
+#endif // QDLT_TIME_FORMATTER_H
@@ -0,0 +1,215 @@
+#include "dltdescriptionindex.h"
+
+#include <QTreeWidget>
+
+#include "project.h"
+
+DltDescriptionIndex::DltDescriptionIndex()
+{
+    tree = 0;
+}
+
+void DltDescriptionIndex::setTree(QTreeWidget *tree)
+{
+    if(this->tree)
+        disconnect(this->tree, 0, this, 0);
+    if(this->tree && this->tree->model())
+        disconnect(this->tree->model(), 0, this, 0);
+
+    this->tree = tree;
+    modelReset();
+
+    if(!tree)
+        return;
+
+    connect(tree, SIGNAL(itemChanged(QTreeWidgetItem*,int)), this, SLOT(itemChanged(QTreeWidgetItem*,int)));
+    connect(tree->model(), SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(rowsInserted(QModelIndex,int,int)));
+    connect(tree->model(), SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), this, SLOT(rowsAboutToBeRemoved(QModelIndex,int,int)));
+    connect(tree->model(), SIGNAL(modelAboutToBeReset()), this, SLOT(modelAboutToBeReset()));
+    connect(tree->model(), SIGNAL(modelReset()), this, SLOT(modelReset()));
+}
+
+QString DltDescriptionIndex::application(const QString &apid)
+{
+    update();
+
+    QHash<quint64, QList<QTreeWidgetItem*> >::const_iterator it = applications.constFind(key(apid));
+    if(it == applications.constEnd())
+        return QString();
+
+    // the packed key can be equal for ids longer than 4 characters
+    foreach(QTreeWidgetItem *item, it.value())
+    {
+        ApplicationItem *appitem = (ApplicationItem*) item;
+        if(appitem->id == apid && !appitem->description.isEmpty())
+            return appitem->description;
+    }
+
+    return QString();
+}
+
+QString DltDescriptionIndex::context(const QString &apid, const QString &ctid)
+{
+    update();
+
+    QHash<quint64, QList<QTreeWidgetItem*> >::const_iterator it = contexts.constFind(key(apid, ctid));
+    if(it == contexts.constEnd())
+        return QString();
+
+    foreach(QTreeWidgetItem *item, it.value())
+    {
+        ContextItem *conitem = (ContextItem*) item;
+        ApplicationItem *appitem = (ApplicationItem*) conitem->parent();
+        if(appitem->id == apid && conitem->id == ctid && !conitem->description.isEmpty())
+            return conitem->description;
+    }
+
+    return QString();
+}
+
+void DltDescriptionIndex::itemChanged(QTreeWidgetItem *item, int column)
+{
+    Q_UNUSED(column);
+
+    // the item is indexed later, it may still be changed
+    pending.insert(item);
+}
+
+void DltDescriptionIndex::rowsInserted(const QModelIndex &parent, int first, int last)
+{
+    // the inserted items may not be constructed completely, they are only remembered
+    QTreeWidgetItem *parentItem = itemFromIndex(parent);
+    for(int row = first; row <= last; row++)
+        addPending(parentItem ? parentItem->child(row) : tree->topLevelItem(row));
+}
+
+void DltDescriptionIndex::rowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    QTreeWidgetItem *parentItem = itemFromIndex(parent);
+    for(int row = first; row <= last; row++)
+        removeItem(parentItem ? parentItem->child(row) : tree->topLevelItem(row));
+}
+
+void DltDescriptionIndex::modelAboutToBeReset()
+{
+    applications.clear();
+    contexts.clear();
+    keys.clear();
+    pending.clear();
+}
+
+void DltDescriptionIndex::modelReset()
+{
+    modelAboutToBeReset();
+
+    if(!tree)
+        return;
+
+    for(int num = 0; num < tree->topLevelItemCount(); num++)
+        addPending(tree->topLevelItem(num));
+}
+
+void DltDescriptionIndex::update()
+{
+    if(pending.isEmpty())
+        return;
+
+    foreach(QTreeWidgetItem *item, pending)
+        indexItem(item);
+    pending.clear();
+}
+
+void DltDescriptionIndex::indexItem(QTreeWidgetItem *item)
+{
+    QHash<quint64, QList<QTreeWidgetItem*> > *index;
+    quint64 itemKey;
+
+    if(item->type() == application_type)
+    {
+        ApplicationItem *appitem = (ApplicationItem*) item;
+        index = &applications;
+        itemKey = key(appitem->id);
+
+        // the keys of the contexts contain the application id
+        for(int num = 0; num < item->childCount(); num++)
+            if(item->child(num)->type() == context_type)
+                indexItem(item->child(num));
+    }
+    else if(item->type() == context_type && item->parent() && item->parent()->type() == application_type)
+    {
+        ContextItem *conitem = (ContextItem*) item;
+        index = &contexts;
+        itemKey = key(((ApplicationItem*) item->parent())->id, conitem->id);
+    }
+    else
+    {
+        return;
+    }
+
+    QHash<QTreeWidgetItem*, quint64>::iterator it = keys.find(item);
+    if(it != keys.end())
+    {
+        if(it.value() == itemKey)
+            return;
+        (*index)[it.value()].removeOne(item);
+        if((*index)[it.value()].isEmpty())
+            index->remove(it.value());
+        it.value() = itemKey;
+    }
+    else
+    {
+        keys.insert(item, itemKey);
+    }
+
+    (*index)[itemKey].append(item);
+}
+
+void DltDescriptionIndex::removeItem(QTreeWidgetItem *item)
+{
+    if(!item)
+        return;
+
+    // only the QTreeWidgetItem part of the item is used, the item may be deleted right now
+    for(int num = 0; num < item->childCount(); num++)
+        removeItem(item->child(num));
+
+    pending.remove(item);
+
+    QHash<QTreeWidgetItem*, quint64>::iterator it = keys.find(item);
+    if(it == keys.end())
+        return;
+
+    QHash<quint64, QList<QTreeWidgetItem*> > &index = item->type() == application_type ? applications : contexts;
+    index[it.value()].removeOne(item);
+    if(index[it.value()].isEmpty())
+        index.remove(it.value());
+    keys.erase(it);
+}
+
+void DltDescriptionIndex::addPending(QTreeWidgetItem *item)
+{
+    if(!item)
+        return;
+
+    pending.insert(item);
+    for(int num = 0; num < item->childCount(); num++)
+        addPending(item->child(num));
+}
+
+QTreeWidgetItem *DltDescriptionIndex::itemFromIndex(const QModelIndex &index) const
+{
+    // QTreeWidget::itemFromIndex() is not public
+    if(!index.isValid() || !tree)
+        return 0;
+
+    QTreeWidgetItem *parentItem = itemFromIndex(index.parent());
+    if(parentItem)
+        return parentItem->child(index.row());
+
+    return tree->topLevelItem(index.row());
+}
+
+quint64 DltDescriptionIndex::key(const QString &apid, const QString &ctid)
+{
+    return ((quint64) QDltMsgView::idFromString(apid) << 32) | QDltMsgView::idFromString(ctid);
+}
@@ -0,0 +1,74 @@
+#ifndef DLTDESCRIPTIONINDEX_H
+#define DLTDESCRIPTIONINDEX_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QString>
+#include <QModelIndex>
+
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/* Descriptions of the applications and contexts in the ECU tree, found by their ids.
+ * The applications are stored by the packed application id and the contexts by the packed
+ * application and context id, so the table views do not search the tree for each cell.
+ * The index follows the changes of the tree: inserted and changed items are indexed again,
+ * when the next description is requested, removed items are removed immediately.
+ * If several items have the same ids, the first indexed item with a description is used. */
+class DltDescriptionIndex : public QObject
+{
+    Q_OBJECT
+public:
+    DltDescriptionIndex();
+
+    // follow the changes of the ECU tree
+    void setTree(QTreeWidget *tree);
+
+    // description of an application, empty if the application is not described
+    QString application(const QString &apid);
+
+    // description of a context, empty if the context is not described
+    QString context(const QString &apid, const QString &ctid);
+
+private slots:
+    void itemChanged(QTreeWidgetItem *item, int column);
+    void rowsInserted(const QModelIndex &parent, int first, int last);
+    void rowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void modelAboutToBeReset();
+    void modelReset();
+
+private:
+    // index the changed items
+    void update();
+
+    // index an item again with its current ids
+    void indexItem(QTreeWidgetItem *item);
+
+    // remove an item and its children from the index, the item can already be destroyed partly
+    void removeItem(QTreeWidgetItem *item);
+
+    // add an item and its children to the changed items
+    void addPending(QTreeWidgetItem *item);
+
+    // find the item of a model index of the tree
+    QTreeWidgetItem *itemFromIndex(const QModelIndex &index) const;
+
+    // key of an application or a context
+    static quint64 key(const QString &apid, const QString &ctid = QString());
+
+    QTreeWidget *tree;
+
+    // applications and contexts by key, in the order they were indexed
+    QHash<quint64, QList<QTreeWidgetItem*> > applications;
+    QHash<quint64, QList<QTreeWidgetItem*> > contexts;
+
+    // key of each indexed item
+    QHash<QTreeWidgetItem*, quint64> keys;
+
+    // inserted and changed items, which are not indexed yet
+    QSet<QTreeWidgetItem*> pending;
+};
+
+#endif // DLTDESCRIPTIONINDEX_H
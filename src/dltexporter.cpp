@@ -52,7 +52,7 @@ void DltExporter::writeCSVLine(int index, QFile *to, QDltMsg msg)
     QString text("");
 
     text += escapeCSVValue(QString("%1").arg(index)).append(",");
-    text += escapeCSVValue(QString("%1.%2").arg(msg.getTimeString()).arg(msg.getMicroseconds(),6,10,QLatin1Char('0'))).append(",");
+    text += escapeCSVValue(QDltTimeFormatter::threadInstance().localTime(msg.getTime(),msg.getMicroseconds())).append(",");
     text += escapeCSVValue(QString("%1.%2").arg(msg.getTimestamp()/10000).arg(msg.getTimestamp()%10000,4,10,QLatin1Char('0'))).append(",");
     text += escapeCSVValue(QString("%1").arg(msg.getMessageCounter())).append(",");
     text += escapeCSVValue(QString("%1").arg(msg.getEcuid())).append(",");
@@ -202,6 +202,11 @@ bool DltExporter::getMsg(unsigned long int num,QDltMsg &msg,QByteArray &buf)
         qDebug() << "Buffer empty in" << __FILE__ << __LINE__;
         return false;
     }
+
+    // messages exported unchanged are only checked, they are not parsed
+    if(exportFormat == DltExporter::FormatDlt)
+        return QDltMsgView(buf).isValid();
+
     return msg.setMsg(buf);
 }
 
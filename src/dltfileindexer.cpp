@@ -10,6 +10,16 @@
 #include <QMutexLocker>
 #include <QDir>
 #include <QFileInfo>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QScopedPointer>
+#include <QHash>
+
+#include <limits.h>
+#include <string.h>
 
 
 extern "C" {
@@ -17,23 +27,43 @@ extern "C" {
     #include "dlt_user.h"
 }
 
-DltFileIndexerKey::DltFileIndexerKey(time_t time, unsigned int microseconds, int index, const QSharedPointer<QDltMsg> &msg)
-    : timestamp(0)
-    , msg(msg)
+/* Worker indexing one chunk of a file in the thread pool */
+class DltFileIndexerChunkRunnable : public QRunnable
 {
-    this->time = time;
-    this->microseconds = microseconds;
-    this->index = index;
-}
+public:
+    DltFileIndexerChunkRunnable(DltFileIndexer *indexer, const QString &filename, qint64 fileSize, DltFileIndexerChunk *chunk)
+        : indexer(indexer), filename(filename), fileSize(fileSize), chunk(chunk) {}
+
+    void run()
+    {
+        // the first chunk starts with the first message, all others must search a message start
+        if(!indexer->indexChunk(filename, fileSize, *chunk, chunk->start > 0))
+            chunk->syncPos = -1; // indexed again during merge
+    }
+
+private:
+    DltFileIndexer *indexer;
+    QString filename;
+    qint64 fileSize;
+    DltFileIndexerChunk *chunk;
+};
 
-DltFileIndexerKey::DltFileIndexerKey(unsigned int timestamp, int index, const QSharedPointer<QDltMsg> &msg)
-    : time(0)
-    , microseconds(0)
-    , msg(msg)
+/* Worker indexing one complete file in the thread pool */
+class DltFileIndexerFileRunnable : public QRunnable
 {
-    this->timestamp = timestamp;
-    this->index = index;
-}
+public:
+    DltFileIndexerFileRunnable(DltFileIndexer *indexer, DltFileIndexerFile *file)
+        : indexer(indexer), file(file) {}
+
+    void run()
+    {
+        file->success = indexer->index(file->num, file->index, file->table, file->errors, file->indexedSize, false);
+    }
+
+private:
+    DltFileIndexer *indexer;
+    DltFileIndexerFile *file;
+};
 
 DltFileIndexer::DltFileIndexer(QObject *parent) :
     QThread(parent)
@@ -84,22 +114,39 @@ DltFileIndexer::~DltFileIndexer()
 {
 }
 
-bool DltFileIndexer::index(int num)
+bool DltFileIndexer::index(int num, QDltIndex &indexList, QDltMsgTable &table, qint64 &errors, qint64 &indexedSize, bool reportProgress)
 {
-    // start performance counter
-    //QTime time(0,0,0,0);
-    // time.start();
+    QString filename = dltFile->getFileName(num);
+
+    // clear old index
+    indexList.clear();
+    table.clear();
+    errors = 0;
+    indexedSize = 0;
 
     // load filter index if enabled
-    if(filterCacheEnabled && loadIndexCache(dltFile->getFileName(num)))
+    DltFileIndexerCacheHeader cachedHeader;
+    int cachedCount = -1;
+    if(filterCacheEnabled && loadIndexCache(filename, indexList, reportProgress, &cachedHeader))
     {
-        // loading index from filter is succesful
-        qDebug() << "Successfully loaded index cache for file" << dltFile->getFileName(num);// << __LINE__;
-        return true;
+        if(cachedHeader.fileSize == QFileInfo(filename).size())
+        {
+            // loading index from filter is succesful
+            qDebug() << "Successfully loaded index cache for file" << filename;// << __LINE__;
+            indexProgress.fetchAndAddRelaxed(QFileInfo(filename).size());
+            indexedSize = cachedHeader.fileSize;
+
+            // the header table is optional, users check if it matches the index
+            indexTable(filename, indexList, table, indexedSize);
+            return true;
+        }
+
+        // file has grown since the cache was written, only the new part is indexed
+        cachedCount = indexList.size();
     }
 
     // prepare indexing
-    QFile f(dltFile->getFileName(num));
+    QFile f(filename);
 
     // open file
     if(!f.open(QIODevice::ReadOnly))
@@ -113,215 +160,171 @@ bool DltFileIndexer::index(int num)
     {
         // No need to do anything here.
         f.close();
-        qWarning() << "File" << dltFile->getFileName(num) << "is empty";
+        qWarning() << "File" << filename << "is empty";
         return true; // because it is just empty, not an error ...
     }
 
-    int modulo = f.size()/2000; // seems to be the propper ratio ...
-    if (modulo == 0) // avoid divison by zero ( very small files )
+    // continue behind the last cached message
+    qint64 pos = 0;
+    if(cachedCount > 0)
     {
-         modulo = 1;
+        QByteArray buf;
+        if(f.seek(indexList.last() + 18) && (buf = f.read(2)).size() == 2)
+        {
+            // Read low and high bytes of message length
+            pos = indexList.last() + (((unsigned char)buf.at(0) << 8) | (unsigned char)buf.at(1)) + 16;
+        }
+        if(pos <= indexList.last() || pos > f.size())
+        {
+            qDebug() << "Cannot continue index cache for file" << filename;
+            indexList.clear();
+            cachedCount = -1;
+            pos = 0;
+        }
     }
+    f.seek(pos);
 
-    qDebug() << "Start creating indexfile for" << dltFile->getFileName(num);
-
-    // clear old index
-    indexAllList.clear();
+    if(cachedCount >= 0)
+        qDebug() << "Continue indexfile for" << filename << "at file position" << pos << "behind" << cachedCount << "cached messages";
+    else
+        qDebug() << "Start creating indexfile for" << filename;
 
     // Go through the segments and create new index
-    char lastFound = 0;
-    qint64 length = 0;
-    qint64 msgindex = 0;
-    qint64 pos = 0;
-    qint64 abspos = 0;
-    qint64 current_message_pos = 0;
-    qint64 next_message_pos = 0;
-    qint64 counter_header = 0;
-    qint64 message_length = 0;
     qint64 readresult = 0;
     qint64 file_size = f.size();
-    qint64 number=0;
-    int iPercent =0;
-    errors_in_file  = 0;
+    qint64 errors_before = 0;
+    int iPercent = 0;
+    int lastPercent = -1;
     char *data = new char[DLT_FILE_INDEXER_SEG_SIZE];
+    QDltIndexScanner scanner(file_size, pos);
+    QElapsedTimer timer;
+    timer.start();
 
     // Initialise progress bar
-    emit(progressText(QString("CI %1/%2").arg(currentRun).arg(maxRun)));
-    emit(progressMax(100));
-    emit(progress(0));
-
+    if(reportProgress)
+    {
+        emit(progressText(QString("CI %1/%2").arg(currentRun).arg(maxRun)));
+        emit(progressMax(100));
+        emit(progress(0));
+    }
 
-    do
+    // large files are split into chunks indexed in parallel, if not already called from a worker thread
+    if(pos == 0 && reportProgress && multithreaded && QThread::idealThreadCount() > 1 && file_size >= 2 * DLT_FILE_INDEXER_CHUNK_MIN_SIZE)
     {
-        pos = f.pos();
-        readresult =f.read(data,DLT_FILE_INDEXER_SEG_SIZE);
-        if (length >= 0)
-        {
-           length = readresult;
-        }
-        else
+        if(!indexChunks(filename, file_size, indexList, errors))
         {
-            qDebug() << "Error reading input file" << f.fileName() << __LINE__;
+            delete[] data;
             f.close();
             return false;
         }
-
-        for(number=0;number < length;number++)
+        pos = file_size;
+    }
+    else
+    {
+        while(true)
         {
-            abspos= pos+number;
-            // search length of DLT message
-            if(counter_header>0)
+            // data appended while indexing is not part of the index and its cache files
+            readresult = f.read(data,qMin((qint64) DLT_FILE_INDEXER_SEG_SIZE, qMax(file_size - pos, (qint64) 0)));
+            if(readresult < 0)
             {
-                counter_header++;
-                if (counter_header==16)
-                {
-                    // Read low byte of message length
-                    message_length = (unsigned char)data[number];
-                }
-                else if (counter_header==17)
-                {
-                    // Read high byte of message length
-                    counter_header = 0;
-                    message_length = (message_length<<8 | ((unsigned char)data[number])) +16;
-                    next_message_pos = current_message_pos + message_length;
-                    if(next_message_pos==file_size)
-                    {
-                        // last message found in file
-                        indexAllList.append(current_message_pos);
-                        break;
-                    }
-                    // speed up move directly to next message, if inside current buffer
-                    if((message_length > 20))
-                    {
-                        if((number+message_length-20<length))
-                        {
-                            number+=message_length-20;
-                        }
-                    }
-                }
+                qDebug() << "Error reading input file" << f.fileName() << __LINE__;
+                delete[] data;
+                f.close();
+                return false;
             }
-            // find DLT Header
-            else if(data[number] == 'D')
+            if(readresult == 0)
+                break; // EOF
+
+            // find all messages in this segment
+            QDltIndexScanner::ScanResult result = scanner.scan(data, readresult, pos, indexList);
+
+            if(scanner.getErrors() != errors_before)
             {
-                lastFound = 'D';
+                // first messages not at beginning or error occured before
+                qDebug() << "ERROR in file" << filename << "detected new start sequence at index" << indexList.size() << "in segment at file position" << pos;
+                qDebug() << "------------";
+                errors_before = scanner.getErrors();
             }
-            else if(lastFound == 'D' && data[number] == 'L')
+
+            if(result == QDltIndexScanner::ScanFinished)
             {
-                lastFound = 'L';
+                // last message found in file
+                pos = file_size;
+                break;
             }
-            else if(lastFound == 'L' && data[number] == 'T')
+            else if(result == QDltIndexScanner::ScanResync)
             {
-                lastFound = 'T';
-            }
-            else if(lastFound == 'T' && data[number] == 0x01)
-            {
-                if(next_message_pos == 0)
-                {
-                    // very first message detected or the first message after an error occured
-                    current_message_pos = pos+number-3;
-                    counter_header = 1;
-                    if(current_message_pos!=0)
-                    {
-                        // first messages not at beginning or error occured before
-                        errors_in_file++;
-                        qDebug() << "ERROR in file" << dltFile->getFileName(num) << "detected new start sequence at index" << msgindex << "msg length" << message_length << "file position" << current_message_pos;
-                        qDebug() << "------------";
-                    }
-                    // speed up and move directly to message length, if it is still inside of the current buffer
-                    if(number+14<length)
-                    {
-                        number+=14;
-                        counter_header+=14;
-                    }
-                }
-                else if( next_message_pos == (pos+number-3) )
-                {
-                    // Add message only when it is in the correct position in relationship to the last message
-                    indexAllList.append(current_message_pos);
-                    msgindex++;
-                    current_message_pos = pos+number-3;
-                    counter_header = 1;
-                    // speed up move directly to message length, if inside current buffer
-                    //if ( (errors_in_file > 0)  &&  ((pos%1000)) )    qDebug() << "Add index "<< msgindex << "at file position" << current_message_pos << pos << number << length;
-
-                    if(number+14 < length)
-                    {
-                        number+=14;
-                        counter_header+=14;
-                    }
-                }
-                else if(next_message_pos > (pos+number-3))
-                {
-                    // Header detected before end of message
-                     qDebug() << "ERROR: Header detected before end of message at index "<< msgindex << "msg length" << message_length << "at file position" << current_message_pos;
-                     errors_in_file++;
-                }
-                else //if(next_message_pos < (pos+number-3))
-                {
-                    // Header detected after end of message
-                    // start search for new message back after last header found
-                    qDebug() << "At index file:" << ( pos *100 )/file_size << "% -" << "Header detected after end of message, offset:" << (pos+number-3) - next_message_pos << "bytes";
-                    f.seek(current_message_pos+4);
-                    pos = current_message_pos+4;
-                    length = f.read(data,DLT_FILE_INDEXER_SEG_SIZE);
-                    number=0;
-                    next_message_pos = 0;
-                }
-                lastFound = 0;
+                // Header detected after end of message
+                // start search for new message back after last header found
+                qDebug() << "At index file:" << ( pos *100 )/file_size << "% -" << "Header detected after end of message at index" << indexList.size();
+                pos = scanner.getResyncPosition();
+                f.seek(pos);
             }
             else
             {
-                lastFound = 0; // no hit, so just go on with search for the startsequence
-                //qDebug() << "DLT recived but not the stop sign 0x01" << msgindex;
+                pos += readresult;
             }
-
+            indexProgress.fetchAndAddRelaxed(readresult);
 
             /* stop if requested */
             if(true == stopFlag)
             {
                 qDebug().noquote() << "Request stoping indexing received" << __LINE__ << __FILE__;
-                emit(progress((abspos)));
+                if(reportProgress)
+                    emit(progress((pos)));
                 delete[] data;
                 f.close();
                 return false;
             }
 
-            if( 0 == (abspos%modulo) && ( file_size > 0 ) )
+            iPercent = ( pos*100 )/file_size;
+            if(reportProgress && iPercent != lastPercent)
             {
-             //qszPercent = QString("Indexed: %1 %").arg(pos, 0, 'f',2);
-             iPercent = ( abspos*100 )/file_size;
-            if( true == QDltOptManager::getInstance()->issilentMode() )
-             {
-               qDebug() << "Create index file:" << iPercent << "%";// << currentRun;//<< pos << f.size() << __LINE__;
-             }
-            else
-             {
-              emit(progress((iPercent)));
-              //qDebug() << "Create index file:" << iPercent << "%";// << currentRun;//<< pos << f.size() << __LINE__;
-             }
+                lastPercent = iPercent;
+                if( true == QDltOptManager::getInstance()->issilentMode() )
+                {
+                    qDebug() << "Create index file:" << iPercent << "%";
+                }
+                else
+                {
+                    emit(progress((iPercent)));
+                }
             }
+        }
 
-        } // end of for loop to read within one segment accross "number"
+        errors = scanner.getErrors();
     }
-    while(length>0); // overall "do loop"
 
-    if ( errors_in_file != 0 )
+    if ( errors != 0 )
     {
-    qDebug() << "Indexing error:" << errors_in_file << "wrong DLT message headers found during indexing" << msgindex << "messages";
+    qDebug() << "Indexing error:" << errors << "wrong DLT message headers found during indexing" << indexList.size() << "messages";
     }
 
     if ( file_size > 0 )
     {
-     qDebug().noquote() << "Created" << ( pos *100 )/file_size << "% index for file" << dltFile->getFileName(num);
+     qDebug().noquote() << "Created" << ( pos *100 )/file_size << "% index for file" << filename;
     }
 
+    // print indexing throughput
+    qint64 msecs = qMax(timer.elapsed(), (qint64)1);
+    qDebug().noquote() << QString("Indexed %1 MB in %2 ms (%3 GB/s, %4 kernel)")
+                          .arg(file_size/(1024*1024))
+                          .arg(msecs)
+                          .arg((double)file_size/msecs/1000000.0, 0, 'f', 2)
+                          .arg(QDltIndexScanner::getKernelName());
+    if(reportProgress)
+        msecsIndexCounter += msecs;
+
+    indexedSize = file_size;
+
     // write index if enabled
     if(filterCacheEnabled)
     {
-        saveIndexCache(dltFile->getFileName(num));
-        qDebug() << "Saved index cache for file" << dltFile->getFileName(num);
+        saveIndexCache(filename, indexList, indexedSize, cachedCount);
+        qDebug() << "Saved index cache for file" << filename;
     }
-    emit(progress(pos));
+    if(reportProgress)
+        emit(progress(pos));
 
     // delete buffer
     delete[] data;
@@ -329,14 +332,362 @@ bool DltFileIndexer::index(int num)
     // close file
     f.close();
 
-    //qDebug() << "Duration:" << time.elapsed()/1000 << __LINE__;
+    // the header table is optional, users check if it matches the index
+    indexTable(filename, indexList, table, indexedSize);
+
+    return true;
+}
+
+bool DltFileIndexer::indexTable(const QString &filename, const QDltIndex &indexList, QDltMsgTable &table, qint64 indexedSize)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // only the rows of messages not in the cache are read from the log file
+    DltFileIndexerCacheHeader cachedHeader;
+    table.clear();
+    if(filterCacheEnabled && loadMsgTableCache(filename, table, &cachedHeader))
+    {
+        // the last cached message may have been incomplete before the file has grown
+        if(cachedHeader.fileSize != indexedSize && !table.isEmpty())
+            table.resize(table.size() - 1);
+        if(table.size() > indexList.size())
+            table.resize(indexList.size());
+    }
+    int cachedRows = table.size();
+    if(cachedRows == indexList.size())
+        return true;
+
+    QFile f(filename);
+    if(!f.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Cannot open file in DltFileIndexer " << f.errorString();
+        table.clear();
+        return false;
+    }
+    bool success = table.update(f, indexList);
+    f.close();
+    if(!success)
+    {
+        qDebug() << "Reading message headers of file" << filename << "failed";
+        table.clear();
+        return false;
+    }
+
+    qDebug().noquote() << QString("Read headers of %1 messages in %2 ms, header table %3 bytes per message")
+                          .arg(table.size() - cachedRows)
+                          .arg(timer.elapsed())
+                          .arg((double) table.memoryUsage() / qMax(table.size(), 1), 0, 'f', 2);
+
+    // write header table if enabled
+    if(filterCacheEnabled)
+        saveMsgTableCache(filename, table, indexedSize);
+
+    return true;
+}
+
+void DltFileIndexer::reportIndexMemory(const QString &name, const QDltIndex &indexList)
+{
+    // the flat layout used a QVector<qint64> with one file position per message
+    qDebug().noquote() << QString("%1: %2 messages, %3 bytes per message, flat QVector<qint64> %4 bytes per message")
+                          .arg(name).arg(indexList.size())
+                          .arg((double) indexList.memoryUsage() / qMax(indexList.size(), 1), 0, 'f', 2)
+                          .arg((int) sizeof(qint64));
+}
+
+bool DltFileIndexer::indexFiles()
+{
+    int count = dltFile->getNumberOfFiles();
+    qint64 errors = 0;
+    qint64 indexedSize = 0;
+    QDltMsgTable table;
+
+    errors_in_file = 0;
+
+    // a single file is indexed in chunks, files are indexed one after the other without multithreading
+    if(!multithreaded || count < 2 || QThread::idealThreadCount() < 2)
+    {
+        for(int num=0;num < count;num++)
+        {
+            if(!index(num, indexAllList, table, errors, indexedSize))
+                return false;
+           // qDebug() << "setDLTIndex" << num << __FILE__ << __LINE__;
+            dltFile->setDltIndex(indexAllList,num,indexedSize);
+            reportIndexMemory(QString("Index of %1").arg(dltFile->getFileName(num)), indexAllList);
+            dltFile->setMsgTable(table,num);
+            errors_in_file += errors;
+            currentRun++;
+        }
+        return true;
+    }
+
+    // index all files in parallel, each file gets its own index
+    QVector<DltFileIndexerFile> files(count);
+    qint64 totalSize = 0;
+    int iPercent = 0;
+    int lastPercent = -1;
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int num=0;num < count;num++)
+    {
+        files[num].num = num;
+        totalSize += QFileInfo(dltFile->getFileName(num)).size();
+    }
+    totalSize = qMax(totalSize, (qint64) 1);
+
+    qDebug() << "Index" << count << "files in parallel";
+
+    // Initialise progress bar
+    emit(progressText(QString("CI %1/%2").arg(currentRun).arg(maxRun)));
+    emit(progressMax(100));
+    emit(progress(0));
+
+    indexProgress = 0;
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMin(QThread::idealThreadCount(), count));
+    for(int num=0;num < count;num++)
+        pool.start(new DltFileIndexerFileRunnable(this, &files[num]));
+
+    while(!pool.waitForDone(100))
+    {
+        iPercent = (int) qMin(indexProgress.load() * 100 / totalSize, (qint64) 100);
+        if(iPercent != lastPercent)
+        {
+            lastPercent = iPercent;
+            if( true == QDltOptManager::getInstance()->issilentMode() )
+            {
+                qDebug() << "Create index file:" << iPercent << "%";
+            }
+            else
+            {
+                emit(progress((iPercent)));
+            }
+        }
+    }
+
+    /* stop if requested */
+    if(true == stopFlag)
+    {
+        qDebug().noquote() << "Request stoping indexing received" << __LINE__ << __FILE__;
+        return false;
+    }
+
+    // hand over the indexes in file order
+    for(int num=0;num < count;num++)
+    {
+        if(!files[num].success)
+            return false;
+        dltFile->setDltIndex(files[num].index,num,files[num].indexedSize);
+        reportIndexMemory(QString("Index of %1").arg(dltFile->getFileName(num)), files[num].index);
+        dltFile->setMsgTable(files[num].table,num);
+        errors_in_file += files[num].errors;
+        files[num].index.clear();
+        files[num].table.clear();
+        currentRun++;
+    }
+    emit(progress(100));
+
+    msecsIndexCounter += timer.elapsed();
+    qDebug().noquote() << QString("Indexed %1 files with %2 MB in %3 ms").arg(count).arg(totalSize/(1024*1024)).arg(timer.elapsed());
+
+    return true;
+}
+
+bool DltFileIndexer::indexChunks(const QString &filename, qint64 fileSize, QDltIndex &indexList, qint64 &errors)
+{
+    int count = (int) qMin((qint64) QThread::idealThreadCount(), fileSize / DLT_FILE_INDEXER_CHUNK_MIN_SIZE);
+    QVector<DltFileIndexerChunk> chunks(count);
+    int iPercent = 0;
+    int lastPercent = -1;
+
+    qDebug() << "Index file" << filename << "in" << count << "chunks";
+
+    // split the file into chunks of the same size
+    for(int i = 0; i < count; i++)
+    {
+        chunks[i].start = fileSize * i / count;
+        chunks[i].end = fileSize * (i + 1) / count;
+    }
+
+    // index all chunks in parallel
+    indexProgress = 0;
+    QThreadPool pool;
+    pool.setMaxThreadCount(count);
+    for(int i = 0; i < count; i++)
+        pool.start(new DltFileIndexerChunkRunnable(this, filename, fileSize, &chunks[i]));
+
+    while(!pool.waitForDone(100))
+    {
+        iPercent = (int) qMin(indexProgress.load() * 100 / fileSize, (qint64) 100);
+        if(iPercent != lastPercent)
+        {
+            lastPercent = iPercent;
+            if( true == QDltOptManager::getInstance()->issilentMode() )
+            {
+                qDebug() << "Create index file:" << iPercent << "%";
+            }
+            else
+            {
+                emit(progress((iPercent)));
+            }
+        }
+    }
+
+    /* stop if requested */
+    if(true == stopFlag)
+    {
+        qDebug().noquote() << "Request stoping indexing received" << __LINE__ << __FILE__;
+        return false;
+    }
+
+    /* Merge the chunks. A chunk is only used, if its first message is the message where the
+       previous chunk stopped, so the result is the same as indexing the file sequentially.
+       Otherwise a wrong message start was found, and the chunk is indexed again
+       starting from the message, where the previous chunk stopped. */
+    qint64 exitPos = 0;
+    qint64 size = 0;
+    for(int i = 0; i < count; i++)
+        size += chunks[i].index.size();
+    indexList.reserve(size);
+    errors = 0;
+    for(int i = 0; i < count; i++)
+    {
+        DltFileIndexerChunk &chunk = chunks[i];
+
+        if(exitPos < 0)
+            break; // end of file reached in previous chunk
+        if(exitPos >= chunk.end)
+            continue; // no message starts in this chunk
+
+        if(chunk.syncPos != exitPos)
+        {
+            qDebug() << "Chunk" << i << "of file" << filename << "starts with wrong message at" << chunk.syncPos << "instead of" << exitPos << ", index chunk again";
+            chunk.start = exitPos;
+            if(!indexChunk(filename, fileSize, chunk, false))
+                return false;
+        }
+
+        indexList.append(chunk.index);
+        errors += chunk.errors;
+        exitPos = chunk.exitPos;
+        chunk.index.clear();
+    }
+
+    return true;
+}
+
+bool DltFileIndexer::indexChunk(const QString &filename, qint64 fileSize, DltFileIndexerChunk &chunk, bool findSync)
+{
+    QFile f(filename);
+    qint64 pos = chunk.start;
+    qint64 readresult = 0;
+
+    chunk.index.clear();
+    chunk.syncPos = -1;
+    chunk.exitPos = -1;
+    chunk.errors = 0;
+
+    // open file
+    if(!f.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Cannot open file in DltFileIndexer " << f.errorString();
+        return false;
+    }
+
+    QByteArray buffer(DLT_FILE_INDEXER_SEG_SIZE, 0);
+    char *data = buffer.data();
+
+    if(findSync)
+    {
+        // find the first message in the chunk, which can be trusted
+        while(chunk.syncPos < 0 && pos < chunk.end)
+        {
+            if(!f.seek(pos) || (readresult = f.read(data, DLT_FILE_INDEXER_SEG_SIZE)) < 0)
+            {
+                qDebug() << "Error reading input file" << f.fileName() << __LINE__;
+                return false;
+            }
+            if(readresult == 0)
+                break; // EOF
+
+            qint64 resumePos = 0;
+            qint64 syncPos = QDltIndexScanner::findSyncPosition(data, readresult, pos, fileSize, resumePos);
+            if(syncPos >= 0)
+            {
+                if(syncPos < chunk.end)
+                    chunk.syncPos = syncPos;
+                break;
+            }
+            pos = resumePos;
+
+            /* stop if requested */
+            if(true == stopFlag)
+                return false;
+        }
+
+        if(chunk.syncPos < 0)
+            return true; // no message starts in this chunk
+    }
+    else
+    {
+        chunk.syncPos = chunk.start;
+    }
+
+    // find all messages up to the first message behind the chunk
+    QDltIndexScanner scanner(fileSize, chunk.syncPos);
+    scanner.setLimit(chunk.end);
+    pos = chunk.syncPos;
+    f.seek(pos);
+    while(true)
+    {
+        readresult = f.read(data, DLT_FILE_INDEXER_SEG_SIZE);
+        if(readresult < 0)
+        {
+            qDebug() << "Error reading input file" << f.fileName() << __LINE__;
+            return false;
+        }
+        if(readresult == 0)
+            break; // EOF
+
+        QDltIndexScanner::ScanResult result = scanner.scan(data, readresult, pos, chunk.index);
+        indexProgress.fetchAndAddRelaxed(readresult);
+
+        if(result == QDltIndexScanner::ScanFinished)
+        {
+            // last message found in file
+            break;
+        }
+        else if(result == QDltIndexScanner::ScanLimit)
+        {
+            // first message of next chunk reached
+            chunk.exitPos = scanner.getLimitPosition();
+            break;
+        }
+        else if(result == QDltIndexScanner::ScanResync)
+        {
+            // start search for new message back after last header found
+            pos = scanner.getResyncPosition();
+            f.seek(pos);
+        }
+        else
+        {
+            pos += readresult;
+        }
+
+        /* stop if requested */
+        if(true == stopFlag)
+            return false;
+    }
+
+    chunk.errors = scanner.getErrors();
 
     return true;
 }
 
 bool DltFileIndexer::indexFilter(QStringList filenames)
 {
-    QSharedPointer<QDltMsg> msg;
+    QDltMsg *msg;
     QDltFilterList filterList;
     QTime time;
     qint64 ix = 0;
@@ -350,14 +701,34 @@ bool DltFileIndexer::indexFilter(QStringList filenames)
     // clear index filter
     indexFilterList.clear();
     indexFilterListSorted.clear();
+    indexMarkList.clear();
     getLogInfoList.clear();
 
     // load filter index, if enabled and not an initial loading of file
-    if(filterCacheEnabled && mode != modeIndexAndFilter && loadFilterIndexCache(filterList,indexFilterList,filenames))
+    DltFileIndexerCacheHeader cachedHeader;
+    int cachedCount = -1;
+    qint64 startIndex = 0;
+    if(filterCacheEnabled && mode != modeIndexAndFilter && loadFilterIndexCache(filterList,indexFilterList,filenames,&cachedHeader))
     {
-        // loading filter index from filter is succesful
-        qDebug() << "Loaded filter index cache for files" << filenames;
-        return true;
+        if(cachedHeader.fileSize == dltFile->indexedSize())
+        {
+            // loading filter index from filter is succesful
+            qDebug() << "Loaded filter index cache for files" << filenames;
+            return true;
+        }
+
+        // files have grown, only new messages are filtered
+        // a sorted index can not be extended
+        if(!sortByTimeEnabled && !sortByTimestampEnabled && cachedHeader.messages <= dltFile->size())
+        {
+            cachedCount = indexFilterList.size();
+            startIndex = cachedHeader.messages;
+            qDebug() << "Extend filter index cache for files" << filenames << "from message" << startIndex;
+        }
+        else
+        {
+            indexFilterList.clear();
+        }
     }
 
     // check if file is empty
@@ -368,6 +739,17 @@ bool DltFileIndexer::indexFilter(QStringList filenames)
         return true;
     }
 
+    // compose the filter index from the bitmaps of the single filters, if all filters were used before
+    // a sorted index needs the time of the messages, so it is always created from the messages
+    if(filterCacheEnabled && mode != modeIndexAndFilter && cachedCount < 0 &&
+       !sortByTimeEnabled && !sortByTimestampEnabled &&
+       composeFilterIndex(filterList, indexFilterList, filenames))
+    {
+        saveFilterIndexCache(filterList, indexFilterList, filenames);
+        qDebug() << "Composed filter index from filter bitmaps for files" << filenames;
+        return true;
+    }
+
     unsigned int modvalue = dltFile->size()/100;
     if (modvalue == 0) // avoid divison by zero
     {
@@ -385,7 +767,34 @@ bool DltFileIndexer::indexFilter(QStringList filenames)
     bool hasPlugins = (activeDecoderPlugins.size() + activeViewerPlugins.size()) > 0;
     bool hasFilters = filterList.filters.size() > 0;
 
-    bool useIndexerThread = hasPlugins || hasFilters;
+    // filters on header fields only are checked without parsing the messages
+    bool useMsgView = !hasPlugins && filterList.isHeaderOnly();
+    QDltMsgView view;
+
+    // the matches of the enabled filters are recorded, so that filter lists combining them later
+    // are composed without reading the messages, the bitmaps are only valid for all messages of the files
+    QScopedPointer<DltFilterBitmapRecorder> recorder;
+    if(filterCacheEnabled && startIndex == 0)
+        recorder.reset(new DltFilterBitmapRecorder(filterList.filters));
+
+    bool useIndexerThread = (hasPlugins || hasFilters) && !useMsgView;
+
+    // the header fields are taken from the header tables, if the tables of all files are complete
+    bool useMsgTable = useMsgView;
+    for(int num = 0; num < dltFile->getNumberOfFiles(); num++)
+    {
+        if(dltFile->getMsgTable(num).size() != dltFile->getFileMsgNumber(num))
+            useMsgTable = false;
+    }
+    int tableNum = 0;   // file of the current message
+    int tableStart = 0; // index of the first message of the file
+
+    // the marks of the filtered messages are created while filtering, messages not parsed are marked by the views
+    indexMarkList.fill(0, dltFile->size());
+
+    // messages are reused after they were processed
+    DltMsgPool msgPool(DLT_MSG_POOL_SIZE);
+    DltMsgPoolBatch msgBatch(&msgPool); // messages of the reading thread
 
     DltFileIndexerThread indexerThread
             (
@@ -395,31 +804,74 @@ bool DltFileIndexer::indexFilter(QStringList filenames)
                 sortByTimestampEnabled,
                 &indexFilterList,
                 &indexFilterListSorted,
+                &indexMarkList,
                 pluginManager,
                 &activeViewerPlugins,
-                silentMode
+                silentMode,
+                &msgPool,
+                recorder.data()
             );
 
+    // the sorted list is checked for duplicate messages
+    indexFilterListSorted.setRemoveDuplicates(hasPlugins || hasFilters);
+
     if(useIndexerThread)
     {
         indexerThread.start(); // thread starts reading its queue
     }
 
+    // messages are read in file order
+    dltFile->adviseAccess(QDltFileItem::AccessSequential);
+
     // Start reading messages
-    for(ix=0;ix<dltFile->size();ix++)
+    for(ix=startIndex;ix<dltFile->size();ix++)
     {
-        msg = QSharedPointer<QDltMsg>::create(); // create new instance to be filled by getMsg(), otherwise shared pointer would be empty or pointing to last message
+        if(useMsgView)
+        {
+            // the message is only read from the log file, if the header fields are not sufficient
+            bool processed = false;
+            if(useMsgTable)
+            {
+                while(ix - tableStart >= dltFile->getFileMsgNumber(tableNum))
+                    tableStart += dltFile->getFileMsgNumber(tableNum++);
+                processed = indexerThread.processMessageTable(dltFile->getMsgTable(tableNum), (int) (ix - tableStart), ix);
+            }
 
-        if(!dltFile->getMsg(ix, *msg))
-            continue; // Skip broken messages
+            // the message is only parsed, if it is a control message
+            if(!processed)
+            {
+                QByteArray data = dltFile->getMsgRaw(ix);
+                if(!view.setMsg(data))
+                    continue; // Skip broken messages
 
-        if(true == useIndexerThread)
-        {
-            indexerThread.enqueueMessage(msg, ix);
+                if(!indexerThread.processMessageView(view, ix))
+                {
+                    msg = msgBatch.acquire();
+                    if(view.toMsg(*msg))
+                        indexerThread.processMessage(msg, ix);
+                    msgBatch.release(msg);
+                }
+            }
         }
         else
         {
-            indexerThread.processMessage(msg, ix);
+            msg = msgBatch.acquire(); // the indexer thread gives the message back, when it is processed
+
+            if(!dltFile->getMsg(ix, *msg))
+            {
+                msgBatch.release(msg);
+                continue; // Skip broken messages
+            }
+
+            if(true == useIndexerThread)
+            {
+                indexerThread.enqueueMessage(msg, ix);
+            }
+            else
+            {
+                indexerThread.processMessage(msg, ix);
+                msgBatch.release(msg);
+            }
         }
 
         // Update progress
@@ -446,9 +898,11 @@ bool DltFileIndexer::indexFilter(QStringList filenames)
                 indexerThread.wait();
             }
 
+            dltFile->adviseAccess(QDltFileItem::AccessRandom);
             return false;
         }
     }
+    dltFile->adviseAccess(QDltFileItem::AccessRandom);
     emit(progress(100));
     // destroy threads
     if(true == useIndexerThread)
@@ -457,22 +911,40 @@ bool DltFileIndexer::indexFilter(QStringList filenames)
         indexerThread.wait();
     }
 
+    qDebug().noquote() << msgPool.statistics();
+    qDebug().noquote() << dltFile->getStringCache()->statistics();
+
     // update performance counter
     //msecsFilterCounter = time.elapsed();
 
     // use sorted values if sort by time enabled
     if(sortByTimeEnabled || sortByTimestampEnabled)
     {
-        indexFilterList = QVector<qint64>::fromList(indexFilterListSorted.values());
+        if(!indexFilterListSorted.sort(indexFilterList))
+            return false;
     }
 
     // write filter index if enabled
     if(filterCacheEnabled)
     {
-        saveFilterIndexCache(filterList, indexFilterList, filenames);
+        saveFilterIndexCache(filterList, indexFilterList, filenames, cachedCount);
         qDebug() << "Saved filter index cache for files" << filenames;
     }
 
+    // write the bitmaps of the single filters
+    if(recorder)
+    {
+        QList<QByteArray> keys = recorder->keys();
+        qint64 memory = recorder->valid().memoryUsage();
+        for(int num = 0; num < keys.size(); num++)
+        {
+            saveFilterBitmap(keys[num], recorder->bitmap(num), filenames);
+            memory += recorder->bitmap(num).memoryUsage();
+        }
+        saveFilterBitmap(QByteArray(), recorder->valid(), filenames);
+        qDebug() << "Saved" << keys.size() << "filter bitmaps using" << memory << "bytes for files" << filenames;
+    }
+
     qDebug() << "Indexed: 100.00 %";// << iPercent << __LINE__ ;
     //qDebug() << "Dauer:" << time.elapsed()/1000 << __LINE__;
     return true;
@@ -480,7 +952,7 @@ bool DltFileIndexer::indexFilter(QStringList filenames)
 
 bool DltFileIndexer::indexDefaultFilter()
 {
-    QSharedPointer<QDltMsg> msg;
+    QDltMsg *msg;
 
     // start performance counter
     //QTime time;
@@ -504,11 +976,16 @@ bool DltFileIndexer::indexDefaultFilter()
 
     bool useDefaultFilterThread = defaultFilter->defaultFilterList.size() > 0;
 
+    // messages are reused after they were processed
+    DltMsgPool msgPool(DLT_MSG_POOL_SIZE);
+    DltMsgPoolBatch msgBatch(&msgPool); // messages of the reading thread
+
     DltFileIndexerDefaultFilterThread defaultFilterThread
             (
                 defaultFilter,
                 pluginManager,
-                silentMode
+                silentMode,
+                &msgPool
             );
 
     if(useDefaultFilterThread)
@@ -517,18 +994,24 @@ bool DltFileIndexer::indexDefaultFilter()
     /* run through the whole open file */
     for(int ix = 0; ix < dltFile->size(); ix++)
     {
-        msg = QSharedPointer<QDltMsg>::create();
+        msg = msgBatch.acquire();
         /* Fill message from file */
         if(!dltFile->getMsg(ix, *msg))
         {
             /* Skip broken messages */
+            msgBatch.release(msg);
             continue;
         }
 
         if(useDefaultFilterThread)
+        {
             defaultFilterThread.enqueueMessage(msg, ix);
+        }
         else
+        {
             defaultFilterThread.processMessage(msg, ix);
+            msgBatch.release(msg);
+        }
 
         /* Update progress */
         if(ix % modulo == 0)
@@ -556,6 +1039,8 @@ bool DltFileIndexer::indexDefaultFilter()
         defaultFilterThread.wait();
     }
 
+    qDebug().noquote() << msgPool.statistics();
+
     /* update plausibility checks of filter index cache, filename and filesize */
     for(int num=0; num < defaultFilter->defaultFilterIndex.size(); num++)
     {
@@ -569,7 +1054,7 @@ bool DltFileIndexer::indexDefaultFilter()
 
         // write filter index if enabled
         if(filterCacheEnabled)
-            saveFilterIndexCache(*filterList, filterIndex->indexFilter, QStringList(dltFile->getFileName()));
+            saveFilterIndexCache(*filterList, QDltIndex(filterIndex->indexFilter), QStringList(dltFile->getFileName()));
     }
 
     // update performance counter
@@ -629,16 +1114,10 @@ void DltFileIndexer::run()
     // index
     if(mode == modeIndexAndFilter)
     {
-        for(int num=0;num < dltFile->getNumberOfFiles();num++)
+        if(!indexFiles())
         {
-            if(!index(num))
-            {
-                qDebug() << "Error in indexer" << __FILE__ << __LINE__;
-                return;
-            }
-           // qDebug() << "setDLTIndex" << num << __FILE__ << __LINE__;
-            dltFile->setDltIndex(indexAllList,num);
-            currentRun++;
+            qDebug() << "Error in indexer" << __FILE__ << __LINE__;
+            return;
         }
         emit(finishIndex());
     }
@@ -661,6 +1140,9 @@ void DltFileIndexer::run()
         }
         dltFile->enableFilter(filtersEnabled);
         dltFile->setIndexFilter(indexFilterList);
+        reportIndexMemory("Filter index", indexFilterList);
+        dltFile->setMsgMarks(indexMarkList);
+        indexMarkList = QVector<quint16>();
         emit(finishFilter());
     }
 
@@ -697,7 +1179,7 @@ void DltFileIndexer::stop()
 }
 
 // load/safe index from/to file
-bool DltFileIndexer::loadIndexCache(QString filename)
+bool DltFileIndexer::loadIndexCache(QString filename, QDltIndex &index, bool reportProgress, DltFileIndexerCacheHeader *cachedHeader)
 {
     QString filenameCache;
 
@@ -714,7 +1196,7 @@ bool DltFileIndexer::loadIndexCache(QString filename)
     if (!dir.exists())
         dir.mkpath(".");
     qDebug() << "Index Cache filename" << info.dir().path() + "/index/" +filenameCache;
-    if(!loadIndex(info.dir().path() + "/index/" +filenameCache,indexAllList))
+    if(!loadIndex(info.dir().path() + "/index/" +filenameCache,index,QStringList(filename),reportProgress,cachedHeader))
     {
         // loading cache file failed
         return false;
@@ -723,7 +1205,7 @@ bool DltFileIndexer::loadIndexCache(QString filename)
     return true;
 }
 
-bool DltFileIndexer::saveIndexCache(QString filename)
+bool DltFileIndexer::saveIndexCache(QString filename, const QDltIndex &index, qint64 indexedSize, int cachedCount)
 {
     QString filenameCache;
 
@@ -740,7 +1222,7 @@ bool DltFileIndexer::saveIndexCache(QString filename)
     if (!dir.exists())
         dir.mkpath(".");
     qDebug() << "Index Cache filename" << info.dir().path() + "/index/" +filenameCache;
-    if(!saveIndex(info.dir().path() + "/index/" +filenameCache,indexAllList))
+    if(!saveIndex(info.dir().path() + "/index/" +filenameCache,index,QStringList(filename),index.size(),indexedSize,cachedCount))
     {
         // saving cache file failed
         return false;
@@ -756,9 +1238,9 @@ QString DltFileIndexer::filenameIndexCache(QString filename)
     QByteArray md5;
     QString filenameCache;
 
-    // create string to be hashed
+    // create string to be hashed, the size is not part of the name,
+    // so the cache is found again after the file has grown
     hashString = QFileInfo(filename).fileName();
-    hashString += "_" + QString("%1").arg(dltFile->fileSize());
 
     // create byte array from hash string
     hashByteArray = hashString.toLatin1();
@@ -774,8 +1256,98 @@ QString DltFileIndexer::filenameIndexCache(QString filename)
     return filenameCache;
 }
 
+// load/save header table from/to file
+bool DltFileIndexer::loadMsgTableCache(QString filename, QDltMsgTable &table, DltFileIndexerCacheHeader *cachedHeader)
+{
+    DltFileIndexerCacheHeader header;
+
+    // check if caching is enabled
+    if(!filterCacheEnabled)
+        return false;
+
+    // the table is stored next to the index cache file
+    QFileInfo info(filename);
+    QString filenameCache = info.dir().path() + "/index/" + filenameMsgTableCache(filename);
+    QFile file(filenameCache);
+    table.clear();
+
+    if(!file.open(QFile::ReadOnly))
+        return false;
+
+    // read and check header, the table is stored behind the header column by column
+    if(file.read((char*)&header,sizeof(header)) != sizeof(header) ||
+       header.version != DLT_FILE_INDEXER_FILE_VERSION ||
+       header.headerSize != sizeof(header) ||
+       header.count < 0 || header.count > INT_MAX ||
+       file.size() != header.headerSize + QDltMsgTable::fileSize((int) header.count))
+    {
+        qDebug() << "Loading header table file " << filenameCache << "failed !";
+        return false;
+    }
+
+    if(!checkCacheHeader(filenameCache, header, QStringList(filename), cachedHeader != 0))
+        return false;
+
+    if(!table.load(file, (int) header.count))
+    {
+        qDebug() << "Loading header table file " << filenameCache << "failed !";
+        return false;
+    }
+
+    if(cachedHeader)
+        *cachedHeader = header;
+
+    qDebug() << "Loaded header table file" << filenameCache << "with" << table.size() << "messages";
+
+    return true;
+}
+
+bool DltFileIndexer::saveMsgTableCache(QString filename, const QDltMsgTable &table, qint64 indexedSize)
+{
+    DltFileIndexerCacheHeader header;
+
+    // check if caching is enabled
+    if(!filterCacheEnabled)
+        return false;
+
+    // save the table in the sudirectory index
+    QFileInfo info(filename);
+    QDir dir(info.dir().path()+"/index");
+    if (!dir.exists())
+        dir.mkpath(".");
+    QString filenameCache = info.dir().path() + "/index/" + filenameMsgTableCache(filename);
+
+    if(!createCacheHeader(QStringList(filename), header, indexedSize))
+        return false;
+    header.count = table.size();
+    header.messages = table.size();
+
+    // the table is always written completely, each column grows when the file grows
+    QSaveFile file(filenameCache);
+    if(!file.open(QFile::WriteOnly))
+        return false;
+
+    if(file.write((char*)&header,sizeof(header)) != sizeof(header) || !table.save(file))
+    {
+        qDebug() << "Writing header table file" << filenameCache << "failed" << file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+
+    return file.commit();
+}
+
+QString DltFileIndexer::filenameMsgTableCache(QString filename)
+{
+    // same name as the index cache file
+    QString filenameCache = filenameIndexCache(filename);
+    filenameCache.chop(4);
+
+    return filenameCache + ".dmt";
+}
+
 // read/write index cache
-bool DltFileIndexer::loadFilterIndexCache(QDltFilterList &filterList, QVector<qint64> &index, QStringList filenames)
+bool DltFileIndexer::loadFilterIndexCache(QDltFilterList &filterList, QDltIndex &index, QStringList filenames, DltFileIndexerCacheHeader *cachedHeader)
 {
     QString filenameCache;
 
@@ -791,7 +1363,7 @@ bool DltFileIndexer::loadFilterIndexCache(QDltFilterList &filterList, QVector<qi
     QDir dir(info.dir().path()+"/index");
     if (!dir.exists())
         dir.mkpath(".");
-    if(loadIndex(info.dir().path() + "/index/" +filenameCache,index))
+    if(loadIndex(info.dir().path() + "/index/" +filenameCache,index,filenames,true,cachedHeader))
     {
         qDebug() << "loadIndex" << info.dir().path() + "/index/" +filenameCache << "success";
     }
@@ -804,7 +1376,7 @@ bool DltFileIndexer::loadFilterIndexCache(QDltFilterList &filterList, QVector<qi
     return true;
 }
 
-bool DltFileIndexer::saveFilterIndexCache(QDltFilterList &filterList, QVector<qint64> index, QStringList filenames)
+bool DltFileIndexer::saveFilterIndexCache(QDltFilterList &filterList, const QDltIndex &index, QStringList filenames, int cachedCount)
 {
     QString filename;
 
@@ -821,7 +1393,7 @@ bool DltFileIndexer::saveFilterIndexCache(QDltFilterList &filterList, QVector<qi
     if (!dir.exists())
         dir.mkpath(".");
     qDebug() << "Filter Index Cache filename" << info.dir().path() + "/index/" +filename;
-    if(!saveIndex(info.dir().path() + "/index/" +filename,index))
+    if(!saveIndex(info.dir().path() + "/index/" +filename,index,filenames,dltFile->size(),dltFile->indexedSize(),cachedCount))
     {
         // saving of cache file failed
         return false;
@@ -853,6 +1425,132 @@ QByteArray DltFileIndexer::md5ActiveDecoderPlugins()
     return md5;
 }
 
+QString DltFileIndexer::filenameFilterBitmapCache(const QByteArray &key, QStringList filenames)
+{
+    QByteArray md5;
+    QString filename;
+
+    // bitmaps are only used for unsorted indexes, so the files are not sorted
+    md5 = QCryptographicHash::hash(filenames.join(QString("_")).toLatin1(), QCryptographicHash::Md5);
+
+    // the messages, which could be filtered, do not depend on the plugins
+    if(key.isEmpty())
+        return QString(md5.toHex()) + "_all.dfb";
+
+    filename = QString(md5.toHex()) + "_" + QString(key.toHex());
+    if(this->pluginsEnabled)
+    {
+        filename += "_" + QString(md5ActiveDecoderPlugins().toHex());
+    }
+    filename += ".dfb";
+
+    return filename;
+}
+
+bool DltFileIndexer::loadFilterBitmap(const QByteArray &key, DltFilterBitmap &bitmap, QStringList filenames)
+{
+    DltFileIndexerCacheHeader header;
+    QString filename = QFileInfo(filenames[0]).dir().path() + "/index/" + filenameFilterBitmapCache(key, filenames);
+
+    bitmap.clear();
+
+    QFile file(filename);
+    if(!file.open(QFile::ReadOnly))
+        return false;
+
+    // the bitmap is only valid for all messages of unchanged log files
+    if(file.read((char*)&header,sizeof(header)) != sizeof(header) ||
+       header.version != DLT_FILE_INDEXER_FILE_VERSION ||
+       header.headerSize != sizeof(header) ||
+       header.messages != dltFile->size() ||
+       !checkCacheHeader(filename, header, filenames, false) ||
+       !bitmap.load(file) ||
+       bitmap.count() != header.count ||
+       !file.atEnd())
+    {
+        qDebug() << "Loading filter bitmap" << filename << "failed";
+        bitmap.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool DltFileIndexer::saveFilterBitmap(const QByteArray &key, const DltFilterBitmap &bitmap, QStringList filenames)
+{
+    DltFileIndexerCacheHeader header;
+    QString filename = QFileInfo(filenames[0]).dir().path() + "/index/" + filenameFilterBitmapCache(key, filenames);
+
+    // the bitmap describes the messages of the indexed part of the files only
+    if(!createCacheHeader(filenames, header, dltFile->indexedSize()))
+        return false;
+    header.count = bitmap.count();
+    header.messages = dltFile->size();
+
+    // the cache file is replaced at once, a partly written bitmap is never loaded
+    QSaveFile file(filename);
+    if(!file.open(QFile::WriteOnly) ||
+       file.write((char*)&header,sizeof(header)) != sizeof(header) ||
+       !bitmap.save(file))
+    {
+        qDebug() << "Writing filter bitmap" << filename << "failed" << file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+
+    return file.commit();
+}
+
+bool DltFileIndexer::composeFilterIndex(QDltFilterList &filterList, QDltIndex &index, QStringList filenames)
+{
+    DltFilterBitmap valid;
+    QHash<QByteArray, DltFilterBitmap*> bitmaps;
+    QList<const DltFilterBitmap*> positive;
+    QList<const DltFilterBitmap*> negative;
+    bool success = true;
+
+    if(!loadFilterBitmap(QByteArray(), valid, filenames))
+        return false;
+
+    // filters matching the same messages share one bitmap
+    for(int num = 0; num < filterList.filters.size() && success; num++)
+    {
+        QDltFilter *filter = filterList.filters[num];
+        if(!filter->enableFilter || (!filter->isPositive() && !filter->isNegative()))
+            continue;
+
+        QByteArray key = filter->createMD5Match();
+        DltFilterBitmap *bitmap = bitmaps.value(key);
+        if(!bitmap)
+        {
+            bitmap = new DltFilterBitmap();
+            bitmaps.insert(key, bitmap);
+            success = loadFilterBitmap(key, *bitmap, filenames);
+        }
+
+        if(filter->isPositive())
+            positive.append(bitmap);
+        else
+            negative.append(bitmap);
+    }
+
+    if(success)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        DltFilterBitmap::compose(valid, positive, negative, index);
+        qDebug().noquote() << QString("Composed %1 of %2 messages from %3 filter bitmaps in %4 ms")
+                              .arg(index.size())
+                              .arg(valid.count())
+                              .arg(bitmaps.size())
+                              .arg(timer.elapsed());
+    }
+
+    qDeleteAll(bitmaps);
+
+    return success;
+}
+
 QString DltFileIndexer::filenameFilterIndexCache(QDltFilterList &filterList,QStringList filenames)
 {
     QString hashString;
@@ -868,7 +1566,6 @@ QString DltFileIndexer::filenameFilterIndexCache(QDltFilterList &filterList,QStr
     if(sortByTimeEnabled || sortByTimestampEnabled)
         filenames.sort();
     hashString = filenames.join(QString("_"));
-    hashString += "_" + QString("%1").arg(dltFile->fileSize());
 
     // create byte array from hash string
     hashByteArray = hashString.toLatin1();
@@ -895,12 +1592,123 @@ QString DltFileIndexer::filenameFilterIndexCache(QDltFilterList &filterList,QStr
     return filename;
 }
 
-bool DltFileIndexer::saveIndex(QString filename, const QVector<qint64> &index)
+bool DltFileIndexer::createCacheHeader(const QStringList &logFilenames, DltFileIndexerCacheHeader &header, qint64 prefixSize)
 {
-    quint32 version = DLT_FILE_INDEXER_FILE_VERSION;
-    qint64 value;
+    QCryptographicHash hash(QCryptographicHash::Md5);
 
-    QFile file(filename);
+    memset(&header, 0, sizeof(header));
+    header.version = DLT_FILE_INDEXER_FILE_VERSION;
+    header.headerSize = sizeof(header);
+
+    // the cache is only valid, if size, modification time and content of all log files are the same
+    for(int num = 0; num < logFilenames.size(); num++)
+    {
+        QFile file(logFilenames[num]);
+        if(!file.open(QFile::ReadOnly))
+            return false;
+
+        qint64 size = file.size();
+        qint64 modified = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+        if(prefixSize >= 0 && prefixSize - header.fileSize < size)
+        {
+            // only the part of the log files, which was indexed before they have grown
+            size = qMax(prefixSize - header.fileSize, (qint64) 0);
+            modified = 0;
+        }
+        header.fileSize += size;
+        header.modified = qMax(header.modified, modified);
+
+        // hash first and last block of the file
+        hash.addData((const char*)&size, sizeof(size));
+        hash.addData(file.read(qMin(size, (qint64) DLT_FILE_INDEXER_CACHE_HASH_SIZE)));
+        if(size > DLT_FILE_INDEXER_CACHE_HASH_SIZE)
+        {
+            qint64 pos = qMax(size - DLT_FILE_INDEXER_CACHE_HASH_SIZE, (qint64) DLT_FILE_INDEXER_CACHE_HASH_SIZE);
+            file.seek(pos);
+            hash.addData(file.read(size - pos));
+        }
+
+        file.close();
+    }
+
+    QByteArray md5 = hash.result();
+    memcpy(header.hash, md5.constData(), qMin((int) sizeof(header.hash), md5.size()));
+
+    return true;
+}
+
+bool DltFileIndexer::checkCacheHeader(QString filename, const DltFileIndexerCacheHeader &header, const QStringList &logFilenames, bool acceptPrefix)
+{
+    DltFileIndexerCacheHeader expected;
+
+    // check if the log files were changed since the cache was written
+    if(!createCacheHeader(logFilenames, expected) ||
+       header.fileSize != expected.fileSize ||
+       header.modified != expected.modified ||
+       memcmp(header.hash, expected.hash, sizeof(header.hash)) != 0)
+    {
+        // the log files may only have grown, the cached part must be unchanged
+        if(!acceptPrefix || header.fileSize >= expected.fileSize ||
+           !createCacheHeader(logFilenames, expected, header.fileSize) ||
+           header.fileSize != expected.fileSize ||
+           memcmp(header.hash, expected.hash, sizeof(header.hash)) != 0)
+        {
+            qDebug() << "Cache file " << filename << "is outdated";
+            return false;
+        }
+        qDebug() << "Cache file " << filename << "is valid for the first" << header.fileSize << "bytes";
+    }
+
+    return true;
+}
+
+bool DltFileIndexer::saveIndex(QString filename, const QDltIndex &index, const QStringList &logFilenames, qint64 messages, qint64 prefixSize, int cachedCount)
+{
+    DltFileIndexerCacheHeader header;
+    const int blockSize = DLT_FILE_INDEXER_SEG_SIZE / sizeof(qint64);
+    QVector<qint64> block;
+
+    if(!createCacheHeader(logFilenames, header, prefixSize))
+        return false;
+    header.count = index.size();
+    header.messages = messages;
+
+    // extend the existing cache file of the smaller log files
+    if(cachedCount >= 0 && cachedCount <= index.size())
+    {
+        DltFileIndexerCacheHeader cachedHeader;
+        QFile file(filename);
+        if(file.open(QFile::ReadWrite) &&
+           file.read((char*)&cachedHeader,sizeof(cachedHeader)) == sizeof(cachedHeader) &&
+           cachedHeader.version == header.version && cachedHeader.headerSize == header.headerSize &&
+           cachedHeader.count == cachedCount && file.size() == header.headerSize + cachedCount * (qint64) sizeof(qint64) &&
+           file.seek(file.size()))
+        {
+            // the existing values are not changed, so the file can still be mapped by an index
+            bool success = true;
+            block.reserve(blockSize);
+            for(int num=cachedCount;num<index.size() && success;num++)
+            {
+                block.append(index.at(num));
+                if(block.size() == blockSize || num == index.size() - 1)
+                {
+                    success = file.write((const char*)block.constData(), block.size() * sizeof(qint64)) == (qint64) (block.size() * sizeof(qint64));
+                    block.clear();
+                }
+            }
+
+            // the header is written last, a cache file with a wrong size is never loaded
+            if(success && file.seek(0) && file.write((char*)&header,sizeof(header)) == sizeof(header) && file.flush())
+            {
+                qDebug() << "Extended index file" << filename << "from" << cachedCount << "to" << index.size() << "values";
+                return true;
+            }
+            qDebug() << "Extending index file" << filename << "failed" << file.errorString();
+        }
+    }
+
+    // the cache file is replaced at once, because an older version can still be mapped by an index
+    QSaveFile file(filename);
 
     // open cache file
     if(!file.open(QFile::WriteOnly))
@@ -909,28 +1717,34 @@ bool DltFileIndexer::saveIndex(QString filename, const QVector<qint64> &index)
         return false;
     }
 
-    // write version
-    file.write((char*)&version,sizeof(version));
+    // write header
+    file.write((char*)&header,sizeof(header));
 
-    // write complete index
+    // write complete index in blocks
+    block.clear();
+    block.reserve(blockSize);
     for(int num=0;num<index.size();num++)
     {
-        value = index[num];
-        file.write((char*)&value,sizeof(value));
+        block.append(index.at(num));
+        if(block.size() == blockSize || num == index.size() - 1)
+        {
+            if(file.write((const char*)block.constData(), block.size() * sizeof(qint64)) != (qint64) (block.size() * sizeof(qint64)))
+            {
+                qDebug() << "Writing index file" << filename << "failed" << file.errorString();
+                file.cancelWriting(); // old cache file is kept
+                return false;
+            }
+            block.clear();
+        }
     }
 
     // close cache file
-    file.close();
-
-    return true;
+    return file.commit();
 }
 
-bool DltFileIndexer::loadIndex(QString filename, QVector<qint64> &index)
+bool DltFileIndexer::loadIndex(QString filename, QDltIndex &index, const QStringList &logFilenames, bool reportProgress, DltFileIndexerCacheHeader *cachedHeader)
 {
-    quint32 version;
-    qint64 value;
-    int length;
-    qint64 indexcount=0;
+    DltFileIndexerCacheHeader header;
 
     QFile file(filename);
     index.clear();
@@ -944,72 +1758,54 @@ bool DltFileIndexer::loadIndex(QString filename, QVector<qint64> &index)
 
     qDebug() << "Load index file " << filename;// << __FILE__ << "LINE" << __LINE__;
 
-    index.reserve(static_cast<int>((file.size() - sizeof(version)) / sizeof(value))); // prevent memory issues through reallocation
-
-    // read version
-    length = file.read((char*)&version,sizeof(version));
+    if (reportProgress && false == QDltOptManager::getInstance()->issilentMode() )
+    {
+        emit(progressText(QString("LI %1/%2").arg(currentRun).arg(maxRun)));
+        emit(progress(0));
+        emit(progressMax(100)); // should be 100
+    }
 
-    // compare version if valid
-    if((length != sizeof(version)) || version != DLT_FILE_INDEXER_FILE_VERSION)
+    // read and check header, compare version first, older versions have a shorter header
+    if(file.read((char*)&header,sizeof(header)) != sizeof(header) ||
+       header.version != DLT_FILE_INDEXER_FILE_VERSION ||
+       header.headerSize != sizeof(header) ||
+       header.count < 0 || header.count > INT_MAX ||
+       file.size() != header.headerSize + header.count * (qint64) sizeof(qint64))
     {
-        // wrong version number
+        // wrong version number or corrupted file
         qDebug() << "Loading index file " << filename << "failed !";
         file.close();
         return false;
     }
+    file.close();
 
-    int modvalue = file.size() / 100;
-    if (modvalue == 0) // avoid divison by zero
-    {
-         modvalue = 1;
-    }
-
-   // read complete index
-   if (false == QDltOptManager::getInstance()->issilentMode() )
-     {
-       emit(progressText(QString("LI %1/%2").arg(currentRun).arg(maxRun)));
-       emit(progress(0));
-       emit(progressMax(100)); // should be 100
-     }
-   else
-     {
-      qDebug().noquote() << "Loading index file: 0 %";
-     }
+    // check if the log files were changed since the cache was written
+    if(!checkCacheHeader(filename, header, logFilenames, cachedHeader != 0))
+        return false;
 
-    do
+    // use the index directly from the cache file
+    if(!index.mapFile(filename, header.headerSize, (int) header.count))
     {
-        length = file.read((char*)&value,sizeof(value));
-        if(length==sizeof(value))
-        {
-            index.append(value);
-        }
-        if( 0 == (indexcount%modvalue) && ( file.size() > 0 ) )
-        {
-         if (false == QDltOptManager::getInstance()->issilentMode() )
-          {
-           emit(progress((indexcount * 800 )/file.size()));
-          }
-        else
-          {
-          qDebug().noquote() << "Loading index file:" << ( indexcount * 8 *100 )/file.size() << "%";
-         }
-        }
-        indexcount++;
-
+        qDebug() << "Loading index file " << filename << "failed !";
+        return false;
     }
-    while(length==sizeof(value));
+
+    if(cachedHeader)
+        *cachedHeader = header;
 
     // now that it is doen we have to set the 100 %
-    if (false == QDltOptManager::getInstance()->issilentMode() )
+    if (!reportProgress)
       {
-        emit(progress(file.size()));
+       // progress is reported by the caller
+      }
+    else if (false == QDltOptManager::getInstance()->issilentMode() )
+      {
+        emit(progress(100));
       }
     else
       {
-       qDebug().noquote() << "Loading index file:" << ( indexcount * 8 *100 )/file.size() << "%";// << length << indexcount << file.size(); //<< pos << f.size() << __LINE__;
+       qDebug().noquote() << "Loading index file: 100 %";
       }
-    // close cache file
-    file.close();
 
     return true;
 }
@@ -7,50 +7,56 @@
 #include <QMainWindow>
 #include <QPair>
 #include <QMutex>
+#include <QAtomicInteger>
 
 #include "qdlt.h"
+#include "dltfileindexersort.h"
+#include "dltfilterbitmap.h"
 
 #define DLT_FILE_INDEXER_SEG_SIZE (1024*1024)
-#define DLT_FILE_INDEXER_FILE_VERSION 2
+#define DLT_FILE_INDEXER_FILE_VERSION 5
+#define DLT_FILE_INDEXER_CACHE_HASH_SIZE (64*1024)
+#define DLT_FILE_INDEXER_CHUNK_MIN_SIZE (32*1024*1024)
 
-class DltFileIndexerKey
+/* Header of an index cache file, followed by the index as native qint64 values */
+struct DltFileIndexerCacheHeader
 {
-public:
-    DltFileIndexerKey(time_t time, unsigned int microseconds, int index, const QSharedPointer<QDltMsg> &msg = nullptr);
-    DltFileIndexerKey(unsigned int timestamp, int index, const QSharedPointer<QDltMsg> &msg = nullptr);
-
-    friend bool operator< (const DltFileIndexerKey &key1, const DltFileIndexerKey &key2);
+    quint32 version;        // DLT_FILE_INDEXER_FILE_VERSION, always first
+    quint32 headerSize;     // size of this header, the index starts behind
+    qint64 fileSize;        // size of all indexed log files
+    qint64 modified;        // last modification of the log files in ms since epoch
+    qint64 count;           // number of values in the index
+    qint64 messages;        // number of messages of the log files covered by the index
+    char hash[16];          // MD5 of the first and last block of each log file
+};
 
-    const QSharedPointer<QDltMsg> msg;
-private:
-    time_t time;
-    unsigned int microseconds;
-    unsigned int timestamp;
-    int index;
+/* One part of a file, which is indexed in parallel to the other parts */
+class DltFileIndexerChunk
+{
+public:
+    DltFileIndexerChunk() : start(0), end(0), syncPos(-1), exitPos(-1), errors(0) {}
+
+    qint64 start;           // first byte of the chunk
+    qint64 end;             // first byte behind the chunk
+    qint64 syncPos;         // first message indexed in the chunk, -1 if none
+    qint64 exitPos;         // first message found behind the chunk, -1 if end of file reached
+    qint64 errors;          // wrong headers found in the chunk
+    QDltIndex index;        // messages found in the chunk
 };
 
-inline bool operator< (const DltFileIndexerKey &key1, const DltFileIndexerKey &key2)
+/* Index of one file, which is indexed in parallel to the other files */
+class DltFileIndexerFile
 {
-    if (key1.timestamp == 0 && key2.timestamp == 0)
-    {
-        if (key1.time < key2.time)
-            return true;
-        if (key1.time > key2.time)
-            return false;
-        if (key1.microseconds < key2.microseconds)
-            return true;
-        if (key1.microseconds > key2.microseconds)
-            return false;
-    }
-    else
-    {
-        if (key1.timestamp < key2.timestamp)
-            return true;
-        if (key1.timestamp > key2.timestamp)
-            return false;
-    }
-    return (key1.index < key2.index);
-}
+public:
+    DltFileIndexerFile() : num(0), errors(0), indexedSize(0), success(false) {}
+
+    int num;                // number of the file in QDltFile
+    qint64 errors;          // wrong headers found in the file
+    qint64 indexedSize;     // size of the file scanned for the index
+    bool success;           // indexing finished without error
+    QDltIndex index;        // messages found in the file
+    QDltMsgTable table;     // header fields of the messages found in the file
+};
 
 class DltFileIndexer : public QThread
 {
@@ -66,8 +72,11 @@ public:
 
     typedef enum { modeNone, modeIndexAndFilter, modeFilter, modeDefaultFilter } IndexingMode;
 
-    // create main index
-    bool index(int num);
+    // create main index and header table of one file, indexedSize is the size of the file scanned for the index
+    bool index(int num, QDltIndex &indexList, QDltMsgTable &table, qint64 &errors, qint64 &indexedSize, bool reportProgress = true);
+
+    // create index of one part of a file, used by the worker threads
+    bool indexChunk(const QString &filename, qint64 fileSize, DltFileIndexerChunk &chunk, bool findSync);
 
     qint64 getfileerrors(void);
 
@@ -76,19 +85,38 @@ public:
     bool indexDefaultFilter();
 
     // load/save filter index from/to file
-    bool loadFilterIndexCache(QDltFilterList &filterList, QVector<qint64> &index, QStringList filenames);
-    bool saveFilterIndexCache(QDltFilterList &filterList, QVector<qint64> index, QStringList filenames);
+    bool loadFilterIndexCache(QDltFilterList &filterList, QDltIndex &index, QStringList filenames, DltFileIndexerCacheHeader *cachedHeader = 0);
+    bool saveFilterIndexCache(QDltFilterList &filterList, const QDltIndex &index, QStringList filenames, int cachedCount = -1);
     QString filenameFilterIndexCache(QDltFilterList &filterList, QStringList filenames);
     QByteArray md5ActiveDecoderPlugins(); // generate hash value over all active decoder plugins
 
+    // load/save the bitmap of the messages matching one filter, key is QDltFilter::createMD5Match()
+    // an empty key is used for the bitmap of all filtered messages
+    bool loadFilterBitmap(const QByteArray &key, DltFilterBitmap &bitmap, QStringList filenames);
+    bool saveFilterBitmap(const QByteArray &key, const DltFilterBitmap &bitmap, QStringList filenames);
+    QString filenameFilterBitmapCache(const QByteArray &key, QStringList filenames);
+
+    // create the filtered index from the cached bitmaps of the enabled filters, false if a bitmap is missing
+    bool composeFilterIndex(QDltFilterList &filterList, QDltIndex &index, QStringList filenames);
+
     // load/save index from/to file
-    bool loadIndexCache(QString filename);
-    bool saveIndexCache(QString filename);
+    bool loadIndexCache(QString filename, QDltIndex &index, bool reportProgress = true, DltFileIndexerCacheHeader *cachedHeader = 0);
+    bool saveIndexCache(QString filename, const QDltIndex &index, qint64 indexedSize, int cachedCount = -1);
     QString filenameIndexCache(QString filename);
 
-    // load/save index from/to file
-    bool saveIndex(QString filename, const QVector<qint64> &index);
-    bool loadIndex(QString filename, QVector<qint64> &index);
+    // load/save index from/to file, the cache file is only valid for the given log files
+    // if cachedHeader is set, also a cache of the log files before they have grown is loaded
+    // if cachedCount is set, the cache file with this number of values is extended
+    // the cache file describes the first prefixSize bytes of the log files, which were indexed
+    bool saveIndex(QString filename, const QDltIndex &index, const QStringList &logFilenames, qint64 messages, qint64 prefixSize, int cachedCount = -1);
+    bool loadIndex(QString filename, QDltIndex &index, const QStringList &logFilenames, bool reportProgress = true, DltFileIndexerCacheHeader *cachedHeader = 0);
+    bool createCacheHeader(const QStringList &logFilenames, DltFileIndexerCacheHeader &header, qint64 prefixSize = -1);
+    bool checkCacheHeader(QString filename, const DltFileIndexerCacheHeader &header, const QStringList &logFilenames, bool acceptPrefix);
+
+    // load/save header table from/to file, a cache of the log file before it has grown is also loaded
+    bool loadMsgTableCache(QString filename, QDltMsgTable &table, DltFileIndexerCacheHeader *cachedHeader = 0);
+    bool saveMsgTableCache(QString filename, const QDltMsgTable &table, qint64 indexedSize);
+    QString filenameMsgTableCache(QString filename);
 
     // Accessors to mutex
     void lock();
@@ -103,6 +131,9 @@ public:
     void setPluginsEnabled(bool enable) { pluginsEnabled = enable; }
     bool getPluginsEnabled() { return pluginsEnabled; }
 
+    // rendered strings of the messages, shared with the views of the file
+    QDltStringCache *getStringCache() { return dltFile->getStringCache(); }
+
     // enable/disable filters
     void setFiltersEnabled(bool enable) { filtersEnabled = enable; }
     bool getFiltersEnabled() { return filtersEnabled; }
@@ -124,8 +155,8 @@ public:
     bool getFilterCacheEnabled() { return filterCacheEnabled; }
 
     // get index of all messages
-    QVector<qint64> getIndexAll() { return indexAllList; }
-    QVector<qint64> getIndexFilters() { return indexFilterList; }
+    QDltIndex getIndexAll() { return indexAllList; }
+    QDltIndex getIndexFilters() { return indexFilterList; }
     QList<int> getGetLogInfoList() { return getLogInfoList; }
 
     // let worker thread append to getLogInfoList
@@ -141,6 +172,18 @@ protected:
 
 private:
 
+    // create main index of all files, in parallel if multithreaded
+    bool indexFiles();
+
+    // create header table of all messages of the index, which are not in the table cache
+    bool indexTable(const QString &filename, const QDltIndex &indexList, QDltMsgTable &table, qint64 indexedSize);
+
+    // create main index of a large file in parallel chunks
+    bool indexChunks(const QString &filename, qint64 fileSize, QDltIndex &indexList, qint64 &errors);
+
+    // log the bytes per message of an index compared to a flat QVector<qint64>
+    void reportIndexMemory(const QString &name, const QDltIndex &indexList);
+
     // the current set mode of indexing
     IndexingMode mode;
 
@@ -165,11 +208,14 @@ private:
     QList<QDltPlugin*> activeDecoderPlugins;
 
     // full index
-    QVector<qint64> indexAllList;
+    QDltIndex indexAllList;
 
     // filtered index
-    QVector<qint64> indexFilterList;
-    QMap<DltFileIndexerKey,qint64> indexFilterListSorted;
+    QDltIndex indexFilterList;
+    DltFileIndexerSort indexFilterListSorted;
+
+    // mark of each filtered message, by message index
+    QVector<quint16> indexMarkList;
 
     // getLogInfoList
     QList<int> getLogInfoList;
@@ -184,9 +230,12 @@ private:
     // filter cache enabled
     bool filterCacheEnabled;
 
-    // file errors
+    // file errors of all files
     qint64 errors_in_file;
 
+    // bytes read by all indexing worker threads
+    QAtomicInteger<qint64> indexProgress;
+
     // run counter
     int maxRun, currentRun;
 
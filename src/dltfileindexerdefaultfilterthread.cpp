@@ -4,18 +4,20 @@ DltFileIndexerDefaultFilterThread::DltFileIndexerDefaultFilterThread
 (
         QDltDefaultFilter *defaultFilter,
         QDltPluginManager *pluginManager,
-        bool silentMode
+        bool silentMode,
+        DltMsgPool *msgPool
 )
     : defaultFilter(defaultFilter),
       pluginManager(pluginManager),
       silentMode(silentMode),
-      msgQueue(1024)
+      msgQueue(1024),
+      msgPool(msgPool)
 {}
 
 DltFileIndexerDefaultFilterThread::~DltFileIndexerDefaultFilterThread()
 {}
 
-void DltFileIndexerDefaultFilterThread::enqueueMessage(const QSharedPointer<QDltMsg> &msg, int index)
+void DltFileIndexerDefaultFilterThread::enqueueMessage(QDltMsg *msg, int index)
 {
     msgQueue.enqueueMsg(msg, index);
 }
@@ -27,13 +29,18 @@ void DltFileIndexerDefaultFilterThread::requestStop()
 
 void DltFileIndexerDefaultFilterThread::run()
 {
-    QPair<QSharedPointer<QDltMsg>, int> msgPair;
+    QPair<QDltMsg*, int> msgPair;
+
+    DltMsgPoolBatch releasedMsgs(msgPool); // processed messages are given back in batches
 
     while(msgQueue.dequeue(msgPair))
+    {
         processMessage(msgPair.first, msgPair.second);
+        releasedMsgs.release(msgPair.first);
+    }
 }
 
-void DltFileIndexerDefaultFilterThread::processMessage(QSharedPointer<QDltMsg> &msg, int index)
+void DltFileIndexerDefaultFilterThread::processMessage(QDltMsg *msg, int index)
 {
     /* Process all decoderplugins */
     pluginManager->decodeMsg(*msg, silentMode);
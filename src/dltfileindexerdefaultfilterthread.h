@@ -3,16 +3,17 @@
 
 #include "dltfileindexer.h"
 #include "dltmsgqueue.h"
+#include "dltmsgpool.h"
 #include <QThread>
 
 class DltFileIndexerDefaultFilterThread :public QThread
 {
     Q_OBJECT
 public:
-    DltFileIndexerDefaultFilterThread(QDltDefaultFilter *defaultFilter, QDltPluginManager *pluginManager, bool silentMode);
+    DltFileIndexerDefaultFilterThread(QDltDefaultFilter *defaultFilter, QDltPluginManager *pluginManager, bool silentMode, DltMsgPool *msgPool);
     ~DltFileIndexerDefaultFilterThread();
-    void enqueueMessage(const QSharedPointer<QDltMsg> &msg, int index);
-    void processMessage(QSharedPointer<QDltMsg> &msg, int index);
+    void enqueueMessage(QDltMsg *msg, int index);
+    void processMessage(QDltMsg *msg, int index);
     void requestStop();
 
 protected:
@@ -24,6 +25,7 @@ private:
     bool silentMode;
 
     DltMsgQueue msgQueue;
+    DltMsgPool *msgPool; // processed messages are given back to the pool
 };
 
 #endif // DLTFILEINDEXERDEFAULTFILTERTHREAD_H
@@ -0,0 +1,337 @@
+#include "dltfileindexersort.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <limits.h>
+#include <string.h>
+
+// number of keys read at once from a run
+#define DLT_FILE_INDEXER_SORT_READ_SIZE (64*1024)
+
+DltFileIndexerKey::DltFileIndexerKey(time_t time, unsigned int microseconds, int index, quint64 fingerprint)
+{
+    // time is read from the 32 bit seconds of the storage header
+    this->high = (quint32) time;
+    this->low = microseconds;
+    this->index = index;
+    this->fingerprintHigh = (quint32) (fingerprint >> 32);
+    this->fingerprintLow = (quint32) fingerprint;
+}
+
+DltFileIndexerKey::DltFileIndexerKey(unsigned int timestamp, int index, quint64 fingerprint)
+{
+    this->high = 0;
+    this->low = timestamp;
+    this->index = index;
+    this->fingerprintHigh = (quint32) (fingerprint >> 32);
+    this->fingerprintLow = (quint32) fingerprint;
+}
+
+/* MurmurHash64A by Austin Appleby, public domain */
+static quint64 murmurHash64(const char *data, int size, quint64 seed)
+{
+    const quint64 m = Q_UINT64_C(0xc6a4a7935bd1e995);
+    const int r = 47;
+    quint64 h = seed ^ ((quint64) size * m);
+
+    const char *end = data + (size & ~7);
+    for(; data != end; data += 8)
+    {
+        quint64 k;
+        memcpy(&k, data, sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    switch(size & 7)
+    {
+    case 7: h ^= (quint64) (uchar) data[6] << 48; // fall through
+    case 6: h ^= (quint64) (uchar) data[5] << 40; // fall through
+    case 5: h ^= (quint64) (uchar) data[4] << 32; // fall through
+    case 4: h ^= (quint64) (uchar) data[3] << 24; // fall through
+    case 3: h ^= (quint64) (uchar) data[2] << 16; // fall through
+    case 2: h ^= (quint64) (uchar) data[1] << 8;  // fall through
+    case 1: h ^= (quint64) (uchar) data[0];
+            h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+
+    return h;
+}
+
+quint64 DltFileIndexerKey::fingerprint(const QByteArray &header, const QByteArray &payload)
+{
+    // header and payload are hashed where they are stored in the message
+    return murmurHash64(payload.constData(), payload.size(), murmurHash64(header.constData(), header.size(), 0));
+}
+
+/* Worker sorting one part of the keys in the thread pool */
+class DltFileIndexerSortRunnable : public QRunnable
+{
+public:
+    DltFileIndexerSortRunnable(DltFileIndexerKey *begin, DltFileIndexerKey *end)
+        : begin(begin), end(end) {}
+
+    void run()
+    {
+        std::sort(begin, end);
+    }
+
+private:
+    DltFileIndexerKey *begin;
+    DltFileIndexerKey *end;
+};
+
+/* Worker merging two sorted neighbouring parts of the keys in the thread pool */
+class DltFileIndexerMergeRunnable : public QRunnable
+{
+public:
+    DltFileIndexerMergeRunnable(const DltFileIndexerKey *begin, const DltFileIndexerKey *middle, const DltFileIndexerKey *end, DltFileIndexerKey *dest)
+        : begin(begin), middle(middle), end(end), dest(dest) {}
+
+    void run()
+    {
+        std::merge(begin, middle, middle, end, dest);
+    }
+
+private:
+    const DltFileIndexerKey *begin;
+    const DltFileIndexerKey *middle;
+    const DltFileIndexerKey *end;
+    DltFileIndexerKey *dest;
+};
+
+/* One sorted run read while merging */
+class DltFileIndexerSortRun
+{
+public:
+    DltFileIndexerSortRun() : file(0), pos(0) {}
+
+    // read the next keys from the file, false if the run is finished
+    bool read()
+    {
+        pos = 0;
+        if(!file)
+        {
+            buffer.clear();
+            return false;
+        }
+        buffer.resize(DLT_FILE_INDEXER_SORT_READ_SIZE);
+        qint64 bytes = file->read((char*) buffer.data(), (qint64) buffer.size() * sizeof(DltFileIndexerKey));
+        buffer.resize(bytes > 0 ? (int) (bytes / sizeof(DltFileIndexerKey)) : 0);
+        return !buffer.isEmpty();
+    }
+
+    QTemporaryFile *file;               // the run, NULL if the run is in memory
+    QVector<DltFileIndexerKey> buffer;  // keys read from the run
+    int pos;                            // next key in buffer
+};
+
+DltFileIndexerSort::DltFileIndexerSort(qint64 memoryLimit)
+{
+    maxKeys = (int) qBound((qint64) DLT_FILE_INDEXER_SORT_CHUNK_MIN_SIZE, memoryLimit / (qint64) sizeof(DltFileIndexerKey), (qint64) INT_MAX);
+    count = 0;
+    runFailed = false;
+    removeDuplicates = false;
+    duplicates = 0;
+}
+
+DltFileIndexerSort::~DltFileIndexerSort()
+{
+    clear();
+}
+
+void DltFileIndexerSort::clear()
+{
+    keys = QVector<DltFileIndexerKey>();
+    qDeleteAll(runs);
+    runs.clear();
+    count = 0;
+    runFailed = false;
+}
+
+void DltFileIndexerSort::append(const DltFileIndexerKey &key)
+{
+    // keep memory usage bounded, if writing fails the keys are sorted in memory
+    if(keys.size() >= maxKeys && !runFailed && !writeRun())
+        runFailed = true;
+
+    keys.append(key);
+    count++;
+}
+
+bool DltFileIndexerSort::sort(QDltIndex &indexList)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    indexList.clear();
+    indexList.reserve((int) count);
+    duplicates = 0;
+
+    bool success = true;
+    if(runs.isEmpty())
+    {
+        sortKeys(keys);
+        for(int num = 0; num < keys.size(); num++)
+            appendSorted(indexList, keys.at(num));
+    }
+    else
+    {
+        success = mergeRuns(indexList);
+    }
+
+    qDebug().noquote() << QString("Sorted %1 messages in %2 ms using %3 temporary files, removed %4 duplicates")
+                          .arg(count)
+                          .arg(timer.elapsed())
+                          .arg(runs.size())
+                          .arg(duplicates);
+
+    clear();
+
+    if(!success)
+        indexList.clear();
+
+    return success;
+}
+
+void DltFileIndexerSort::sortKeys(QVector<DltFileIndexerKey> &keys)
+{
+    int threads = QThread::idealThreadCount();
+    int size = keys.size();
+
+    if(threads < 2 || size < 2 * DLT_FILE_INDEXER_SORT_CHUNK_MIN_SIZE)
+    {
+        std::sort(keys.begin(), keys.end());
+        return;
+    }
+
+    // sort equal parts in parallel
+    int chunks = qMin(threads, size / DLT_FILE_INDEXER_SORT_CHUNK_MIN_SIZE);
+    QVector<int> bounds;
+    for(int num = 0; num <= chunks; num++)
+        bounds.append((int) ((qint64) size * num / chunks));
+
+    DltFileIndexerKey *data = keys.data();
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for(int num = 0; num < chunks; num++)
+        pool.start(new DltFileIndexerSortRunnable(data + bounds[num], data + bounds[num + 1]));
+    pool.waitForDone();
+
+    // merge neighbouring parts in parallel until one part is left
+    QVector<DltFileIndexerKey> buffer(size);
+    DltFileIndexerKey *source = data;
+    DltFileIndexerKey *dest = buffer.data();
+    while(bounds.size() > 2)
+    {
+        QVector<int> next;
+        int parts = bounds.size() - 1;
+        for(int num = 0; num < parts; num += 2)
+        {
+            next.append(bounds[num]);
+            if(num + 1 < parts)
+                pool.start(new DltFileIndexerMergeRunnable(source + bounds[num], source + bounds[num + 1], source + bounds[num + 2], dest + bounds[num]));
+            else
+                std::copy(source + bounds[num], source + bounds[num + 1], dest + bounds[num]);
+        }
+        next.append(size);
+        pool.waitForDone();
+
+        std::swap(source, dest);
+        bounds = next;
+    }
+
+    if(source != data)
+        std::copy(source, source + size, data);
+}
+
+bool DltFileIndexerSort::writeRun()
+{
+    QTemporaryFile *file = new QTemporaryFile(QDir::tempPath() + "/dlt_viewer_sort_XXXXXX");
+    qint64 bytes = (qint64) keys.size() * sizeof(DltFileIndexerKey);
+
+    sortKeys(keys);
+
+    if(!file->open() || file->write((const char*) keys.constData(), bytes) != bytes || !file->flush())
+    {
+        qDebug() << "Writing sort run" << file->fileName() << "failed" << file->errorString();
+        delete file;
+        return false;
+    }
+
+    runs.append(file);
+    keys.clear(); // capacity is kept for the next run
+
+    return true;
+}
+
+bool DltFileIndexerSort::mergeRuns(QDltIndex &indexList)
+{
+    // the keys not written to a file are merged as last run
+    QVector<DltFileIndexerSortRun> sources(runs.size() + 1);
+    for(int num = 0; num < runs.size(); num++)
+    {
+        sources[num].file = runs[num];
+        if(!runs[num]->seek(0))
+            return false;
+        sources[num].read();
+    }
+    sortKeys(keys);
+    sources[runs.size()].buffer = keys;
+
+    // runs are few, the smallest key is searched linearly
+    while(true)
+    {
+        int min = -1;
+        for(int num = 0; num < sources.size(); num++)
+        {
+            const DltFileIndexerSortRun &run = sources.at(num);
+            if(run.pos < run.buffer.size() &&
+               (min < 0 || run.buffer.at(run.pos) < sources.at(min).buffer.at(sources.at(min).pos)))
+            {
+                min = num;
+            }
+        }
+        if(min < 0)
+            break;
+
+        DltFileIndexerSortRun &run = sources[min];
+        appendSorted(indexList, run.buffer.at(run.pos));
+        if(++run.pos >= run.buffer.size())
+            run.read();
+    }
+
+    if(indexList.size() + duplicates != count)
+    {
+        qDebug() << "Reading sort runs failed" << indexList.size() << "of" << count << "messages";
+        return false;
+    }
+
+    return true;
+}
+
+void DltFileIndexerSort::appendSorted(QDltIndex &indexList, const DltFileIndexerKey &key)
+{
+    // a duplicate has the same time as the previous message, so it is found in the sorted order
+    if(removeDuplicates && !indexList.isEmpty() && key.isDuplicate(lastSorted))
+    {
+        duplicates++;
+        return;
+    }
+
+    indexList.append(key.getIndex());
+    lastSorted = key;
+}
@@ -0,0 +1,119 @@
+#ifndef DLTFILEINDEXERSORT_H
+#define DLTFILEINDEXERSORT_H
+
+#include <QVector>
+#include <QList>
+#include <QTemporaryFile>
+
+#include "qdlt.h"
+
+// keys kept in memory before sorted runs are written to temporary files
+#define DLT_FILE_INDEXER_SORT_MEMORY_LIMIT (256*1024*1024)
+
+// minimum number of keys sorted by one thread
+#define DLT_FILE_INDEXER_SORT_CHUNK_MIN_SIZE (64*1024)
+
+/* Compact sort key of one message, sorted by time and microseconds or by timestamp,
+ * messages with the same time are kept in index order */
+class DltFileIndexerKey
+{
+public:
+    DltFileIndexerKey() : high(0), low(0), index(0), fingerprintHigh(0), fingerprintLow(0) {}
+    DltFileIndexerKey(time_t time, unsigned int microseconds, int index, quint64 fingerprint = 0);
+    DltFileIndexerKey(unsigned int timestamp, int index, quint64 fingerprint = 0);
+
+    friend bool operator< (const DltFileIndexerKey &key1, const DltFileIndexerKey &key2);
+
+    int getIndex() const { return index; }
+
+    // check if two keys have the same time and the same message content
+    bool isDuplicate(const DltFileIndexerKey &key) const
+    {
+        return high == key.high && low == key.low &&
+               fingerprintHigh == key.fingerprintHigh && fingerprintLow == key.fingerprintLow;
+    }
+
+    // 64 bit hash of the message content, to find duplicates without comparing the messages
+    static quint64 fingerprint(const QByteArray &header, const QByteArray &payload);
+
+private:
+    quint32 high;           // time in seconds, 0 if sorted by timestamp
+    quint32 low;            // microseconds or timestamp
+    qint32 index;           // position of the message in the index of all messages
+    quint32 fingerprintHigh;// fingerprint of the message, split to keep the key 4 byte aligned
+    quint32 fingerprintLow;
+};
+
+inline bool operator< (const DltFileIndexerKey &key1, const DltFileIndexerKey &key2)
+{
+    if (key1.high != key2.high)
+        return key1.high < key2.high;
+    if (key1.low != key2.low)
+        return key1.low < key2.low;
+    return (key1.index < key2.index);
+}
+
+/* Sorts the filtered messages by time without keeping the messages in memory.
+ * Keys are collected in memory up to a limit, sorted in parallel,
+ * and written as sorted runs to temporary files, when the limit is exceeded.
+ * The runs are merged when the sorted index is created, duplicates are
+ * removed while the sorted index is written. */
+class DltFileIndexerSort
+{
+public:
+    DltFileIndexerSort(qint64 memoryLimit = DLT_FILE_INDEXER_SORT_MEMORY_LIMIT);
+    ~DltFileIndexerSort();
+
+    // remove all keys and runs
+    void clear();
+
+    // add the key of one message
+    void append(const DltFileIndexerKey &key);
+
+    // number of added keys
+    qint64 size() const { return count; }
+
+    // remove messages with the same time and content as the previous message in the sorted index
+    void setRemoveDuplicates(bool enable) { removeDuplicates = enable; }
+    bool getRemoveDuplicates() const { return removeDuplicates; }
+
+    // create the sorted index, all keys are removed afterwards
+    bool sort(QDltIndex &indexList);
+
+    // sort keys in memory, in parallel if the number of keys is large
+    static void sortKeys(QVector<DltFileIndexerKey> &keys);
+
+private:
+    // sort the keys in memory and write them to a temporary file
+    bool writeRun();
+
+    // merge all runs into the sorted index
+    bool mergeRuns(QDltIndex &indexList);
+
+    // append the next key to the sorted index
+    void appendSorted(QDltIndex &indexList, const DltFileIndexerKey &key);
+
+    // maximum number of keys kept in memory
+    int maxKeys;
+
+    // number of added keys
+    qint64 count;
+
+    // keys not written to a run yet
+    QVector<DltFileIndexerKey> keys;
+
+    // sorted runs written to temporary files
+    QList<QTemporaryFile*> runs;
+
+    // writing a run failed, all keys are kept in memory
+    bool runFailed;
+
+    // duplicates are removed from the sorted index
+    bool removeDuplicates;
+
+    // last key appended to the sorted index and number of removed duplicates
+    DltFileIndexerKey lastSorted;
+    qint64 duplicates;
+};
+
+#endif // DLTFILEINDEXERSORT_H
@@ -9,11 +9,14 @@ DltFileIndexerThread::DltFileIndexerThread
         QDltFilterList *filterList,
         bool sortByTimeEnabled,
         bool sortByTimestampEnabled,
-        QVector<qint64> *indexFilterList,
-        QMap<DltFileIndexerKey,qint64> *indexFilterListSorted,
+        QDltIndex *indexFilterList,
+        DltFileIndexerSort *indexFilterListSorted,
+        QVector<quint16> *indexMarkList,
         QDltPluginManager *pluginManager,
         QList<QDltPlugin*> *activeViewerPlugins,
-        bool silentMode
+        bool silentMode,
+        DltMsgPool *msgPool,
+        DltFilterBitmapRecorder *recorder
 )
     :indexer(indexer),
       filterList(filterList),
@@ -21,9 +24,12 @@ DltFileIndexerThread::DltFileIndexerThread
       sortByTimestampEnabled(sortByTimestampEnabled),
       indexFilterList(indexFilterList),
       indexFilterListSorted(indexFilterListSorted),
+      indexMarkList(indexMarkList),
       pluginManager(pluginManager),
       activeViewerPlugins(activeViewerPlugins),
-      silentMode(silentMode), msgQueue(1024)
+      silentMode(silentMode), msgQueue(1024),
+      msgPool(msgPool),
+      recorder(recorder)
 {
 
 }
@@ -33,7 +39,7 @@ DltFileIndexerThread::~DltFileIndexerThread()
 
 }
 
-void DltFileIndexerThread::enqueueMessage(const QSharedPointer<QDltMsg> &msg, int index)
+void DltFileIndexerThread::enqueueMessage(QDltMsg *msg, int index)
 {
     msgQueue.enqueueMsg(msg, index);
 }
@@ -48,29 +54,19 @@ void DltFileIndexerThread::requestStop()
 
 void DltFileIndexerThread::run()
 {
-    QPair<QSharedPointer<QDltMsg>, int> msgPair;
-    while(msgQueue.dequeue(msgPair))
-        processMessage(msgPair.first, msgPair.second);
+    QPair<QDltMsg*, int> msgPair;
+    DltMsgPoolBatch releasedMsgs(msgPool); // processed messages are given back in batches
 
-    //here the sorted list is checked for duplicate messages
-    QByteArray prev_buf;
-    auto keys = indexFilterListSorted->keys();
-    for (auto &key : keys)
+    while(msgQueue.dequeue(msgPair))
     {
-        QByteArray buf;
-        key.msg.data()->getMsg(buf);
-
-        if (buf == prev_buf)
-        {
-            indexFilterListSorted->remove(key);
-        }
-        prev_buf = buf;
+        processMessage(msgPair.first, msgPair.second);
+        releasedMsgs.release(msgPair.first);
     }
-#if 0
-#endif
+
+    // duplicate messages are removed from the sorted list while sorting
 }
 
-void DltFileIndexerThread::processMessage(QSharedPointer<QDltMsg> &msg, int index)
+void DltFileIndexerThread::processMessage(QDltMsg *msg, int index)
 {
     DltFileIndexer::IndexingMode mode = indexer->getMode();
     bool pluginsEnabled = indexer->getPluginsEnabled();
@@ -143,16 +139,22 @@ void DltFileIndexerThread::processMessage(QSharedPointer<QDltMsg> &msg, int inde
      }
 
 
-    bool_result = filterList->checkFilter(*msg);
+    bool_result = filterList->checkFilter(*msg, indexer->getStringCache(), index);
     if ( bool_result == true)
     {
+        /* the views read the markers and automatic marks of the message from the stored mark */
+        if(index < indexMarkList->size())
+            (*indexMarkList)[index] = QDltFile::createMsgMark(*msg, filterList->checkMarkerPosition(*msg, indexer->getStringCache(), index));
+
         if(sortByTimeEnabled)
          {
-            indexFilterListSorted->insert(DltFileIndexerKey(msg->getTime(), msg->getMicroseconds(), index, QSharedPointer<QDltMsg>(msg)), index);
+            quint64 fingerprint = DltFileIndexerKey::fingerprint(msg->getHeader(), msg->getPayload());
+            indexFilterListSorted->append(DltFileIndexerKey(msg->getTime(), msg->getMicroseconds(), index, fingerprint));
          }
         else if(sortByTimestampEnabled)
          {
-            indexFilterListSorted->insert(DltFileIndexerKey(msg->getTimestamp(), index, QSharedPointer<QDltMsg>(msg)), index);
+            quint64 fingerprint = DltFileIndexerKey::fingerprint(msg->getHeader(), msg->getPayload());
+            indexFilterListSorted->append(DltFileIndexerKey(msg->getTimestamp(), index, fingerprint));
          }
         else
          {
@@ -160,6 +162,9 @@ void DltFileIndexerThread::processMessage(QSharedPointer<QDltMsg> &msg, int inde
          }
     }
 
+    if(recorder)
+        recorder->record(*msg, indexer->getStringCache(), index);
+
     /* Offer messages again to viewer plugins after decode */
     if((mode == DltFileIndexer::modeIndexAndFilter) && pluginsEnabled)
     {
@@ -191,3 +196,71 @@ void DltFileIndexerThread::processMessage(QSharedPointer<QDltMsg> &msg, int inde
         }
     }
 }
+
+/* Filter a message with header only filters without parsing it.
+ * Returns false for control messages, which must be processed with processMessage(). */
+bool DltFileIndexerThread::processMessageView(const QDltMsgView &msg, int index)
+{
+    if(msg.getType() == QDltMsg::DltTypeControl)
+        return false;
+
+    if(filterList->checkFilter(msg))
+    {
+        if(sortByTimeEnabled)
+         {
+            quint64 fingerprint = DltFileIndexerKey::fingerprint(msg.getHeader(), msg.getPayload());
+            indexFilterListSorted->append(DltFileIndexerKey(msg.getTime(), msg.getMicroseconds(), index, fingerprint));
+         }
+        else if(sortByTimestampEnabled)
+         {
+            quint64 fingerprint = DltFileIndexerKey::fingerprint(msg.getHeader(), msg.getPayload());
+            indexFilterListSorted->append(DltFileIndexerKey(msg.getTimestamp(), index, fingerprint));
+         }
+        else
+         {
+            indexFilterList->append(index);
+         }
+    }
+
+    if(recorder)
+        recorder->record(msg, index);
+
+    return true;
+}
+
+/* Filter a message with header only filters with the header fields of the message table,
+ * without reading the message from the log file.
+ * Returns false for control messages, incomplete messages and matching messages, which are
+ * needed to remove duplicates while sorting, these must be processed with processMessageView(). */
+bool DltFileIndexerThread::processMessageTable(const QDltMsgTable &table, int row, int index)
+{
+    if(!table.isValid(row) || table.getType(row) == QDltMsg::DltTypeControl)
+        return false;
+
+    bool sortEnabled = sortByTimeEnabled || sortByTimestampEnabled;
+
+    if(filterList->checkFilter(table, row))
+    {
+        // duplicates are found by the fingerprint of the whole message
+        if(sortEnabled && indexFilterListSorted->getRemoveDuplicates())
+            return false;
+
+        if(sortByTimeEnabled)
+         {
+            indexFilterListSorted->append(DltFileIndexerKey(table.getTime(row), table.getMicroseconds(row), index));
+         }
+        else if(sortByTimestampEnabled)
+         {
+            indexFilterListSorted->append(DltFileIndexerKey(table.getTimestamp(row), index));
+         }
+        else
+         {
+            indexFilterList->append(index);
+         }
+    }
+
+    if(recorder)
+        recorder->record(table, row, index);
+
+    return true;
+}
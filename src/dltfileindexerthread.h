@@ -3,16 +3,20 @@
 
 #include "dltfileindexer.h"
 #include "dltmsgqueue.h"
+#include "dltmsgpool.h"
+#include "dltfilterbitmap.h"
 #include <QThread>
 
 class DltFileIndexerThread :public QThread
 {
     Q_OBJECT
 public:
-    DltFileIndexerThread(DltFileIndexer *indexer, QDltFilterList *filterList, bool sortByTimeEnabled, bool sortByTimestampEnabled, QVector<qint64> *indexFilterList, QMap<DltFileIndexerKey,qint64> *indexFilterListSorted, QDltPluginManager *pluginManager, QList<QDltPlugin*> *activeViewerPlugins, bool silentMode);
+    DltFileIndexerThread(DltFileIndexer *indexer, QDltFilterList *filterList, bool sortByTimeEnabled, bool sortByTimestampEnabled, QDltIndex *indexFilterList, DltFileIndexerSort *indexFilterListSorted, QVector<quint16> *indexMarkList, QDltPluginManager *pluginManager, QList<QDltPlugin*> *activeViewerPlugins, bool silentMode, DltMsgPool *msgPool, DltFilterBitmapRecorder *recorder = 0);
     ~DltFileIndexerThread();
-    void enqueueMessage(const QSharedPointer<QDltMsg> &msg, int index);
-    void processMessage(QSharedPointer<QDltMsg> &msg, int index);
+    void enqueueMessage(QDltMsg *msg, int index);
+    void processMessage(QDltMsg *msg, int index);
+    bool processMessageView(const QDltMsgView &msg, int index);
+    bool processMessageTable(const QDltMsgTable &table, int row, int index);
     void requestStop();
 
 protected:
@@ -24,14 +28,17 @@ private:
     bool sortByTimeEnabled;
     bool sortByTimestampEnabled;
 
-    QVector<qint64> *indexFilterList;
-    QMap<DltFileIndexerKey,qint64> *indexFilterListSorted;
+    QDltIndex *indexFilterList;
+    DltFileIndexerSort *indexFilterListSorted;
+    QVector<quint16> *indexMarkList; // mark of each filtered message, by message index
 
     QDltPluginManager *pluginManager;
     QList<QDltPlugin*> *activeViewerPlugins;
     bool silentMode;
 
     DltMsgQueue msgQueue;
+    DltMsgPool *msgPool; // processed messages are given back to the pool
+    DltFilterBitmapRecorder *recorder; // records the matches of each filter, if not NULL
 };
 
 #endif // DLTFILEINDEXERTHREAD_H
@@ -0,0 +1,292 @@
+#include "dltfilterbitmap.h"
+
+#include <QDebug>
+#include <string.h>
+
+// number of 64 bit words of a block stored as plain bits
+#define DLT_FILTER_BITMAP_WORDS (DLT_FILTER_BITMAP_BLOCK_SIZE / 64)
+
+// marker of a block stored as plain bits in a file
+#define DLT_FILTER_BITMAP_PLAIN 0xFFFFFFFF
+
+DltFilterBitmap::DltFilterBitmap()
+{
+    bits = 0;
+}
+
+void DltFilterBitmap::clear()
+{
+    blocks.clear();
+    bits = 0;
+}
+
+void DltFilterBitmap::append(qint64 index)
+{
+    quint32 key = (quint32) (index / DLT_FILTER_BITMAP_BLOCK_SIZE);
+    quint16 position = (quint16) (index % DLT_FILTER_BITMAP_BLOCK_SIZE);
+
+    if(blocks.isEmpty() || blocks.last().key != key)
+    {
+        blocks.append(Block());
+        blocks.last().key = key;
+    }
+
+    Block &block = blocks.last();
+    if(block.words.isEmpty())
+    {
+        block.positions.append(position);
+
+        // a full list of positions is larger than the plain bits
+        if(block.positions.size() > DLT_FILTER_BITMAP_ARRAY_MAX)
+        {
+            QVector<quint64> words(DLT_FILTER_BITMAP_WORDS, 0);
+            orInto(block, words.data());
+            block.words = words;
+            block.positions = QVector<quint16>();
+        }
+    }
+    else
+    {
+        block.words[position / 64] |= Q_UINT64_C(1) << (position % 64);
+    }
+
+    bits++;
+}
+
+qint64 DltFilterBitmap::memoryUsage() const
+{
+    qint64 size = (qint64) blocks.capacity() * sizeof(Block);
+
+    for(int num = 0; num < blocks.size(); num++)
+        size += blocks[num].positions.capacity() * sizeof(quint16) + blocks[num].words.capacity() * sizeof(quint64);
+
+    return size;
+}
+
+bool DltFilterBitmap::save(QIODevice &device) const
+{
+    quint32 count = blocks.size();
+    if(device.write((const char*) &bits, sizeof(bits)) != sizeof(bits) ||
+       device.write((const char*) &count, sizeof(count)) != sizeof(count))
+        return false;
+
+    for(int num = 0; num < blocks.size(); num++)
+    {
+        const Block &block = blocks[num];
+        quint32 size = block.words.isEmpty() ? (quint32) block.positions.size() : DLT_FILTER_BITMAP_PLAIN;
+        qint64 bytes = block.words.isEmpty() ? (qint64) block.positions.size() * sizeof(quint16)
+                                             : (qint64) block.words.size() * sizeof(quint64);
+        const char *data = block.words.isEmpty() ? (const char*) block.positions.constData()
+                                                 : (const char*) block.words.constData();
+
+        if(device.write((const char*) &block.key, sizeof(block.key)) != sizeof(block.key) ||
+           device.write((const char*) &size, sizeof(size)) != sizeof(size) ||
+           device.write(data, bytes) != bytes)
+            return false;
+    }
+
+    return true;
+}
+
+bool DltFilterBitmap::load(QIODevice &device)
+{
+    quint32 count;
+
+    clear();
+
+    if(device.read((char*) &bits, sizeof(bits)) != sizeof(bits) ||
+       device.read((char*) &count, sizeof(count)) != sizeof(count))
+    {
+        clear();
+        return false;
+    }
+
+    blocks.resize(count);
+    for(int num = 0; num < blocks.size(); num++)
+    {
+        Block &block = blocks[num];
+        quint32 size;
+
+        if(device.read((char*) &block.key, sizeof(block.key)) != sizeof(block.key) ||
+           device.read((char*) &size, sizeof(size)) != sizeof(size) ||
+           (size != DLT_FILTER_BITMAP_PLAIN && size > DLT_FILTER_BITMAP_ARRAY_MAX) ||
+           (num > 0 && block.key <= blocks[num - 1].key))
+        {
+            // corrupted file
+            clear();
+            return false;
+        }
+
+        qint64 bytes;
+        char *data;
+        if(size == DLT_FILTER_BITMAP_PLAIN)
+        {
+            block.words.resize(DLT_FILTER_BITMAP_WORDS);
+            bytes = (qint64) block.words.size() * sizeof(quint64);
+            data = (char*) block.words.data();
+        }
+        else
+        {
+            block.positions.resize(size);
+            bytes = (qint64) block.positions.size() * sizeof(quint16);
+            data = (char*) block.positions.data();
+        }
+
+        if(device.read(data, bytes) != bytes)
+        {
+            clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const DltFilterBitmap::Block *DltFilterBitmap::findBlock(int &cursor, quint32 key) const
+{
+    while(cursor < blocks.size() && blocks[cursor].key < key)
+        cursor++;
+
+    if(cursor < blocks.size() && blocks[cursor].key == key)
+        return &blocks[cursor];
+
+    return 0;
+}
+
+void DltFilterBitmap::orInto(const Block &block, quint64 *words)
+{
+    if(block.words.isEmpty())
+    {
+        for(int num = 0; num < block.positions.size(); num++)
+        {
+            quint16 position = block.positions[num];
+            words[position / 64] |= Q_UINT64_C(1) << (position % 64);
+        }
+    }
+    else
+    {
+        for(int num = 0; num < DLT_FILTER_BITMAP_WORDS; num++)
+            words[num] |= block.words[num];
+    }
+}
+
+void DltFilterBitmap::andNotInto(const Block &block, quint64 *words)
+{
+    if(block.words.isEmpty())
+    {
+        for(int num = 0; num < block.positions.size(); num++)
+        {
+            quint16 position = block.positions[num];
+            words[position / 64] &= ~(Q_UINT64_C(1) << (position % 64));
+        }
+    }
+    else
+    {
+        for(int num = 0; num < DLT_FILTER_BITMAP_WORDS; num++)
+            words[num] &= ~block.words[num];
+    }
+}
+
+void DltFilterBitmap::compose(const DltFilterBitmap &valid, const QList<const DltFilterBitmap*> &positive,
+                              const QList<const DltFilterBitmap*> &negative, QDltIndex &index)
+{
+    quint64 words[DLT_FILTER_BITMAP_WORDS];
+    QVector<int> positiveCursor(positive.size(), 0);
+    QVector<int> negativeCursor(negative.size(), 0);
+
+    index.clear();
+
+    // all matching messages are valid messages, so only the blocks of the valid messages are combined
+    for(int num = 0; num < valid.blocks.size(); num++)
+    {
+        const Block &validBlock = valid.blocks[num];
+
+        memset(words, 0, sizeof(words));
+        if(positive.isEmpty())
+        {
+            orInto(validBlock, words);
+        }
+        else
+        {
+            for(int pos = 0; pos < positive.size(); pos++)
+            {
+                const Block *block = positive[pos]->findBlock(positiveCursor[pos], validBlock.key);
+                if(block)
+                    orInto(*block, words);
+            }
+        }
+
+        for(int pos = 0; pos < negative.size(); pos++)
+        {
+            const Block *block = negative[pos]->findBlock(negativeCursor[pos], validBlock.key);
+            if(block)
+                andNotInto(*block, words);
+        }
+
+        // the set bits are the filtered messages in file order
+        qint64 first = (qint64) validBlock.key * DLT_FILTER_BITMAP_BLOCK_SIZE;
+        for(int word = 0; word < DLT_FILTER_BITMAP_WORDS; word++)
+        {
+            quint64 value = words[word];
+            while(value)
+            {
+                int bit = 0;
+                while(!(value & (Q_UINT64_C(1) << bit)))
+                    bit++;
+                index.append(first + word * 64 + bit);
+                value &= value - 1;
+            }
+        }
+    }
+}
+
+DltFilterBitmapRecorder::DltFilterBitmapRecorder(const QList<QDltFilter*> &filters)
+{
+    // only the enabled filters, which create the filtered index, are recorded,
+    // filters which match the same messages are recorded once
+    for(int num = 0; num < filters.size(); num++)
+    {
+        if(!filters[num]->enableFilter || (!filters[num]->isPositive() && !filters[num]->isNegative()))
+            continue;
+
+        QByteArray key = filters[num]->createMD5Match();
+        if(!bitmapKeys.contains(key))
+        {
+            bitmapKeys.append(key);
+            this->filters.append(filters[num]);
+        }
+    }
+
+    bitmaps.resize(bitmapKeys.size());
+    plan.compile(this->filters, QList<QDltFilter*>());
+}
+
+void DltFilterBitmapRecorder::record(QDltMsg &msg, QDltStringCache *cache, qint64 index)
+{
+    validBitmap.append(index);
+
+    plan.matchEach(msg, cache, index, matches);
+    for(int num = 0; num < bitmaps.size(); num++)
+        if(matches.testBit(num))
+            bitmaps[num].append(index);
+}
+
+void DltFilterBitmapRecorder::record(const QDltMsgView &msg, qint64 index)
+{
+    validBitmap.append(index);
+
+    plan.matchEach(msg, matches);
+    for(int num = 0; num < bitmaps.size(); num++)
+        if(matches.testBit(num))
+            bitmaps[num].append(index);
+}
+
+void DltFilterBitmapRecorder::record(const QDltMsgTable &table, int row, qint64 index)
+{
+    validBitmap.append(index);
+
+    plan.matchEach(table, row, matches);
+    for(int num = 0; num < bitmaps.size(); num++)
+        if(matches.testBit(num))
+            bitmaps[num].append(index);
+}
@@ -0,0 +1,103 @@
+#ifndef DLTFILTERBITMAP_H
+#define DLTFILTERBITMAP_H
+
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QBitArray>
+#include <QIODevice>
+#include "qdlt.h"
+
+// messages covered by one block of a bitmap
+#define DLT_FILTER_BITMAP_BLOCK_SIZE 65536
+
+// blocks with more set bits are stored as plain bits instead of a list of positions
+#define DLT_FILTER_BITMAP_ARRAY_MAX 4096
+
+/* Compressed bitmap of the messages matching one filter.
+ * The messages are split into blocks of 64k messages. Each block stores
+ * either the positions of the set bits or all bits, whichever is smaller,
+ * empty blocks are not stored. Bits are appended in increasing order
+ * while the file is filtered. */
+class DltFilterBitmap
+{
+public:
+    DltFilterBitmap();
+
+    // remove all bits
+    void clear();
+
+    // set the bit of a message, index must be larger than all set bits
+    void append(qint64 index);
+
+    // number of set bits
+    qint64 count() const { return bits; }
+
+    // memory used by the blocks in bytes
+    qint64 memoryUsage() const;
+
+    // write/read the bitmap, the format is native and only used for cache files
+    bool save(QIODevice &device) const;
+    bool load(QIODevice &device);
+
+    // create the filtered index: all messages of a positive bitmap, or all valid messages
+    // if there is no positive bitmap, which are not in a negative bitmap
+    static void compose(const DltFilterBitmap &valid, const QList<const DltFilterBitmap*> &positive,
+                        const QList<const DltFilterBitmap*> &negative, QDltIndex &index);
+
+private:
+    class Block
+    {
+    public:
+        Block() : key(0) {}
+
+        quint32 key;                // first message of the block divided by the block size
+        QVector<quint16> positions; // set bits, if words is empty
+        QVector<quint64> words;     // all bits of the block, empty if stored as positions
+    };
+
+    // get the block with the key, the cursor is moved forward to the block
+    const Block *findBlock(int &cursor, quint32 key) const;
+
+    // combine the bits of a block with a plain bitmap
+    static void orInto(const Block &block, quint64 *words);
+    static void andNotInto(const Block &block, quint64 *words);
+
+    QVector<Block> blocks;
+    qint64 bits;
+};
+
+/* Records the bitmaps of the enabled positive and negative filters of a filter list
+ * while the file is filtered, filters which match the same messages share one bitmap.
+ * Also the messages, which could be parsed and were filtered, are recorded. */
+class DltFilterBitmapRecorder
+{
+public:
+    DltFilterBitmapRecorder(const QList<QDltFilter*> &filters);
+
+    // check each filter with a parsed and decoded message
+    void record(QDltMsg &msg, QDltStringCache *cache, qint64 index);
+
+    // check each filter with the header of a message, only valid if the filter list is header only
+    void record(const QDltMsgView &msg, qint64 index);
+
+    // check each filter with the header fields of a message table, only valid if the filter list is header only
+    void record(const QDltMsgTable &table, int row, qint64 index);
+
+    // recorded bitmaps, the key is QDltFilter::createMD5Match()
+    QList<QByteArray> keys() const { return bitmapKeys; }
+    const DltFilterBitmap &bitmap(int num) const { return bitmaps.at(num); }
+
+    // messages which were filtered
+    const DltFilterBitmap &valid() const { return validBitmap; }
+
+private:
+    QList<QDltFilter*> filters; // one filter of each bitmap
+    QList<QByteArray> bitmapKeys;
+    QVector<DltFilterBitmap> bitmaps;
+    DltFilterBitmap validBitmap;
+    QDltFilterPlan plan;
+    QBitArray matches;
+};
+
+#endif // DLTFILTERBITMAP_H
@@ -0,0 +1,134 @@
+#include "dltmsgpool.h"
+
+DltMsgPool::DltMsgPool(int maxSize)
+    : maxSize(maxSize),
+      acquired(0),
+      allocated(0),
+      deleted(0)
+{
+    freeMessages.reserve(maxSize);
+}
+
+DltMsgPool::~DltMsgPool()
+{
+    qDeleteAll(freeMessages);
+}
+
+QDltMsg *DltMsgPool::acquire()
+{
+    QMutexLocker locker(&mutex);
+
+    acquired++;
+    if(!freeMessages.isEmpty())
+    {
+        QDltMsg *msg = freeMessages.last();
+        freeMessages.removeLast();
+        return msg;
+    }
+
+    allocated++;
+    return new QDltMsg();
+}
+
+void DltMsgPool::acquire(QVector<QDltMsg*> &messages, int count)
+{
+    QMutexLocker locker(&mutex);
+
+    acquired += count;
+    while(count > 0 && !freeMessages.isEmpty())
+    {
+        messages.append(freeMessages.last());
+        freeMessages.removeLast();
+        count--;
+    }
+
+    allocated += count;
+    for(;count > 0;count--)
+        messages.append(new QDltMsg());
+}
+
+void DltMsgPool::release(QDltMsg *msg)
+{
+    if(!msg)
+        return;
+
+    QMutexLocker locker(&mutex);
+
+    if(freeMessages.size() < maxSize)
+    {
+        freeMessages.append(msg);
+        return;
+    }
+
+    deleted++;
+    delete msg;
+}
+
+void DltMsgPool::release(QVector<QDltMsg*> &messages, int count)
+{
+    count = qMin(count, messages.size());
+
+    QMutexLocker locker(&mutex);
+
+    for(;count > 0;count--)
+    {
+        QDltMsg *msg = messages.last();
+        messages.removeLast();
+
+        if(freeMessages.size() < maxSize)
+        {
+            freeMessages.append(msg);
+        }
+        else
+        {
+            deleted++;
+            delete msg;
+        }
+    }
+}
+
+QString DltMsgPool::statistics() const
+{
+    return QString("Message pool: %1 messages taken from the pool, %2 allocated, %3 reused, %4 deleted")
+            .arg(acquired)
+            .arg(allocated)
+            .arg(acquired - allocated)
+            .arg(deleted);
+}
+
+DltMsgPoolBatch::DltMsgPoolBatch(DltMsgPool *pool)
+    : pool(pool)
+{
+    messages.reserve(2 * DLT_MSG_POOL_BATCH_SIZE);
+}
+
+DltMsgPoolBatch::~DltMsgPoolBatch()
+{
+    flush();
+}
+
+QDltMsg *DltMsgPoolBatch::acquire()
+{
+    if(messages.isEmpty())
+        pool->acquire(messages, DLT_MSG_POOL_BATCH_SIZE);
+
+    QDltMsg *msg = messages.last();
+    messages.removeLast();
+    return msg;
+}
+
+void DltMsgPoolBatch::release(QDltMsg *msg)
+{
+    if(!msg)
+        return;
+
+    messages.append(msg);
+    if(messages.size() >= 2 * DLT_MSG_POOL_BATCH_SIZE)
+        pool->release(messages, DLT_MSG_POOL_BATCH_SIZE);
+}
+
+void DltMsgPoolBatch::flush()
+{
+    if(!messages.isEmpty())
+        pool->release(messages, messages.size());
+}
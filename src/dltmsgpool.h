@@ -0,0 +1,79 @@
+#ifndef DLTMSGPOOL_H
+#define DLTMSGPOOL_H
+
+#include <QMutex>
+#include <QVector>
+#include <QString>
+#include "qdlt.h"
+
+// released messages kept for reuse, more than a DltMsgQueue can hold
+#define DLT_MSG_POOL_SIZE 2048
+
+// messages taken from or given back to the pool with one lock
+#define DLT_MSG_POOL_BATCH_SIZE 64
+
+/* Recycles message objects passed from the reading thread to the indexer threads.
+ * A message is taken from the pool with acquire() and given back with release()
+ * after it was processed, possibly by another thread, so only a few messages
+ * are allocated for the whole file instead of one per message.
+ * QDltMsg::setMsg() overwrites the ids, header and payload of a reused message
+ * in place, so their memory is reused as well. */
+class DltMsgPool
+{
+public:
+    DltMsgPool(int maxSize);
+    ~DltMsgPool();
+
+    // get an unused message, it is overwritten by QDltMsg::setMsg()
+    QDltMsg *acquire();
+
+    // append a number of unused messages to a list
+    void acquire(QVector<QDltMsg*> &messages, int count);
+
+    // give back a message, which is not used anymore
+    void release(QDltMsg *msg);
+
+    // give back the last messages of a list, they are removed from the list
+    void release(QVector<QDltMsg*> &messages, int count);
+
+    // allocator counters
+    qint64 getAcquired() const { return acquired; }
+    qint64 getAllocated() const { return allocated; }
+    qint64 getReused() const { return acquired - allocated; }
+
+    // counters as text for the log
+    QString statistics() const;
+
+private:
+    QMutex mutex;
+    QVector<QDltMsg*> freeMessages;
+    int maxSize; // further released messages are deleted
+
+    qint64 acquired;
+    qint64 allocated;
+    qint64 deleted;
+};
+
+/* Messages of a pool used by one thread. The pool is locked once for a batch
+ * of messages, released messages are used again by the same thread first. */
+class DltMsgPoolBatch
+{
+public:
+    DltMsgPoolBatch(DltMsgPool *pool);
+    ~DltMsgPoolBatch();
+
+    // get an unused message
+    QDltMsg *acquire();
+
+    // give back a message, the pool gets a batch back when the thread holds too many
+    void release(QDltMsg *msg);
+
+    // give back all messages to the pool
+    void flush();
+
+private:
+    DltMsgPool *pool;
+    QVector<QDltMsg*> messages;
+};
+
+#endif // DLTMSGPOOL_H
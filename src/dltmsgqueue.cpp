@@ -3,7 +3,7 @@
 
 DltMsgQueue::DltMsgQueue(int size)
     : bufferSize(size),
-      buffer(new QPair<QSharedPointer<QDltMsg>, int> [size]),
+      buffer(new QPair<QDltMsg*, int> [size]),
       readPosition(0),
       writePosition(0),
       stopRequested(false),
@@ -17,7 +17,7 @@ DltMsgQueue::~DltMsgQueue()
         delete[] buffer;
 }
 
-void DltMsgQueue::enqueueMsg(const QSharedPointer<QDltMsg> &msg, int index)
+void DltMsgQueue::enqueueMsg(QDltMsg *msg, int index)
 {
     int nextWritePosition = (writePosition.load() + 1) % bufferSize;
 
@@ -37,7 +37,7 @@ void DltMsgQueue::enqueueMsg(const QSharedPointer<QDltMsg> &msg, int index)
     writePosition.store(nextWritePosition);
 }
 
-bool DltMsgQueue::dequeue(QPair<QSharedPointer<QDltMsg>, int> &dequeuedData)
+bool DltMsgQueue::dequeue(QPair<QDltMsg*, int> &dequeuedData)
 {
     while(readPosition.load() == writePosition.load()) // buffer empty?
     {
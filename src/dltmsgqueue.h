@@ -2,7 +2,6 @@
 #define DLTMSGQUEUE_H
 
 #include <QSemaphore>
-#include <QSharedPointer>
 #include "qdlt.h"
 
 class DltMsgQueue
@@ -10,13 +9,13 @@ class DltMsgQueue
 public:
     DltMsgQueue(int bufferSize);
     ~DltMsgQueue();
-    void enqueueMsg(const QSharedPointer<QDltMsg> &msg, int index);
-    bool dequeue(QPair<QSharedPointer<QDltMsg>, int> &dequeuedData);
+    void enqueueMsg(QDltMsg *msg, int index);
+    bool dequeue(QPair<QDltMsg*, int> &dequeuedData);
     void enqueueStopRequest();
 
 private:
     int bufferSize;
-    QPair<QSharedPointer<QDltMsg>, int> *buffer;
+    QPair<QDltMsg*, int> *buffer;
     QAtomicInt readPosition, writePosition;
     volatile bool stopRequested;
     int writeSleepTime; // Microseconds to sleep if buffer is full during a write attempt
@@ -0,0 +1,180 @@
+#include "dltrowcache.h"
+
+#include <QDebug>
+
+DltRowCache::DltRowCache(int maxRows)
+    : decodeMutex(QMutex::Recursive),
+      cache(maxRows),
+      file(0),
+      pluginManager(0),
+      nextRequest(0),
+      decode(false),
+      generation(0),
+      stopFlag(false),
+      hits(0),
+      misses(0),
+      prefetched(0)
+{
+}
+
+DltRowCache::~DltRowCache()
+{
+    stop();
+}
+
+QSharedPointer<const DltRowCacheEntry> DltRowCache::createRow(QDltFile *file, QDltPluginManager *pluginManager, qint64 index, bool decode)
+{
+    QSharedPointer<DltRowCacheEntry> row(new DltRowCacheEntry());
+
+    row->valid = file->getMsg((int) index, row->msg);
+    if(!row->valid)
+        return row;
+
+    // QDltPluginManager::decodeMsg() calls the decoder plugins under its plugin list mutex,
+    // the same lock the GUI, search and indexer threads decode with
+    if(decode && pluginManager)
+        pluginManager->decodeMsg(row->msg, !QDltOptManager::getInstance()->issilentMode());
+
+    // the payload string is shared with the string cache of the file
+    row->payload = file->getStringCache()->payload(index, row->msg).trimmed().replace('\n', ' ');
+
+    return row;
+}
+
+QSharedPointer<const DltRowCacheEntry> DltRowCache::row(QDltFile *file, QDltPluginManager *pluginManager, qint64 index, bool decode)
+{
+    quint64 rowGeneration;
+    {
+        QMutexLocker locker(&mutex);
+
+        QSharedPointer<const DltRowCacheEntry> *cached = cache.object(index);
+        if(cached)
+        {
+            hits++;
+            return *cached;
+        }
+        misses++;
+        rowGeneration = generation;
+    }
+
+    // not prefetched yet, the visible row is decoded now, the background thread does not decode at the same time
+    QMutexLocker decodeLocker(&decodeMutex);
+    QSharedPointer<const DltRowCacheEntry> row = createRow(file, pluginManager, index, decode);
+
+    QMutexLocker locker(&mutex);
+    if(rowGeneration == generation)
+        cache.insert(index, new QSharedPointer<const DltRowCacheEntry>(row));
+
+    return row;
+}
+
+void DltRowCache::prefetch(QDltFile *file, QDltPluginManager *pluginManager, const QVector<qint64> &indexes, bool decode)
+{
+    QMutexLocker locker(&mutex);
+
+    this->file = file;
+    this->pluginManager = pluginManager;
+    this->decode = decode;
+
+    // rows already cached are not decoded again
+    requests.clear();
+    nextRequest = 0;
+    for(int num = 0; num < indexes.size(); num++)
+        if(!cache.contains(indexes[num]))
+            requests.append(indexes[num]);
+
+    if(requests.isEmpty())
+        return;
+
+    if(!isRunning())
+    {
+        stopFlag = false;
+        start(QThread::LowPriority);
+    }
+    wakeup.wakeAll();
+}
+
+void DltRowCache::clear()
+{
+    // a row decoded at the moment is finished before the file may be changed
+    QMutexLocker decodeLocker(&decodeMutex);
+    QMutexLocker locker(&mutex);
+
+    cache.clear();
+    requests.clear();
+    nextRequest = 0;
+    generation++;
+}
+
+void DltRowCache::setMaxRows(int maxRows)
+{
+    QMutexLocker locker(&mutex);
+
+    if(cache.maxCost() != maxRows)
+        cache.setMaxCost(maxRows);
+}
+
+QString DltRowCache::statistics() const
+{
+    QMutexLocker locker(&mutex);
+
+    qint64 lookups = hits + misses;
+
+    return QString("Row cache: %1 of %2 rows, hit rate %3 % of %4 lookups, %5 rows prefetched")
+            .arg(cache.count())
+            .arg(cache.maxCost())
+            .arg(lookups > 0 ? 100.0 * hits / lookups : 0.0, 0, 'f', 1)
+            .arg(lookups)
+            .arg(prefetched);
+}
+
+void DltRowCache::stop()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopFlag = true;
+        wakeup.wakeAll();
+    }
+    wait();
+}
+
+void DltRowCache::run()
+{
+    while(true)
+    {
+        QMutexLocker decodeLocker(&decodeMutex);
+        QMutexLocker locker(&mutex);
+
+        // decodeMutex is released while waiting, so clear() and lock() do not wait for new requests
+        while(!stopFlag && nextRequest >= requests.size())
+        {
+            decodeLocker.unlock();
+            wakeup.wait(&mutex);
+            locker.unlock();
+            decodeLocker.relock();
+            locker.relock();
+        }
+        if(stopFlag)
+            break;
+
+        qint64 index = requests[nextRequest++];
+        if(cache.contains(index))
+            continue;
+
+        QDltFile *rowFile = file;
+        QDltPluginManager *rowPluginManager = pluginManager;
+        bool rowDecode = decode;
+        quint64 rowGeneration = generation;
+        locker.unlock();
+
+        // the file is not changed while decodeMutex is held
+        QSharedPointer<const DltRowCacheEntry> row = createRow(rowFile, rowPluginManager, index, rowDecode);
+
+        locker.relock();
+        if(rowGeneration == generation && !cache.contains(index))
+        {
+            cache.insert(index, new QSharedPointer<const DltRowCacheEntry>(row));
+            prefetched++;
+        }
+    }
+}
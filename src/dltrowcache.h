@@ -0,0 +1,91 @@
+#ifndef DLTROWCACHE_H
+#define DLTROWCACHE_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QCache>
+#include <QSharedPointer>
+#include <QVector>
+#include <QString>
+#include "qdlt.h"
+
+// minimum number of rows kept in the cache
+#define DLT_ROW_CACHE_MIN_ROWS 512
+
+// the cache keeps this number of viewports, the visible rows and the rows prefetched above and below
+#define DLT_ROW_CACHE_VIEWPORTS 6
+
+/* One parsed, decoded and rendered row of the message table */
+class DltRowCacheEntry
+{
+public:
+    DltRowCacheEntry() : valid(false) {}
+
+    QDltMsg msg;        // parsed and decoded message
+    QString payload;    // payload in one line, as shown in the table
+    bool valid;         // the message could be parsed
+};
+
+/* LRU cache of decoded rows of the message table, the rows are found by the index of the message.
+ * A background thread decodes the rows above and below the visible rows in advance,
+ * so scrolling does not read and decode the messages again.
+ * The cache must be cleared, when the file or the decoder plugins are changed. */
+class DltRowCache : public QThread
+{
+    Q_OBJECT
+public:
+    DltRowCache(int maxRows = DLT_ROW_CACHE_MIN_ROWS);
+    ~DltRowCache();
+
+    // get the row of a message, the message is read and decoded now if it is not cached
+    QSharedPointer<const DltRowCacheEntry> row(QDltFile *file, QDltPluginManager *pluginManager, qint64 index, bool decode);
+
+    // decode rows in the background in the given order, earlier requests are replaced
+    void prefetch(QDltFile *file, QDltPluginManager *pluginManager, const QVector<qint64> &indexes, bool decode);
+
+    // remove all rows and wait until the background thread does not read the file anymore
+    void clear();
+
+    // hold back the background thread, while the index of the file is updated or viewer plugins are called
+    void lock() { decodeMutex.lock(); }
+    void unlock() { decodeMutex.unlock(); }
+
+    // set the number of cached rows
+    void setMaxRows(int maxRows);
+
+    // hits, misses and prefetched rows as text for the log
+    QString statistics() const;
+
+protected:
+    void run();
+
+private:
+    // read, decode and render a message
+    static QSharedPointer<const DltRowCacheEntry> createRow(QDltFile *file, QDltPluginManager *pluginManager, qint64 index, bool decode);
+
+    // stop the background thread
+    void stop();
+
+    mutable QMutex mutex;       // protects the cache, the requests and the counters
+    QMutex decodeMutex;         // held while a row is decoded, recursive for rows decoded while locked
+    QWaitCondition wakeup;
+
+    QCache<qint64, QSharedPointer<const DltRowCacheEntry> > cache;
+
+    // prefetch request
+    QDltFile *file;
+    QDltPluginManager *pluginManager;
+    QVector<qint64> requests;
+    int nextRequest;
+    bool decode;
+
+    quint64 generation;         // incremented by clear(), rows decoded before are dropped
+    bool stopFlag;
+
+    qint64 hits;
+    qint64 misses;
+    qint64 prefetched;
+};
+
+#endif // DLTROWCACHE_H
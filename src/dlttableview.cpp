@@ -1,8 +1,13 @@
+#include <QElapsedTimer>
+
 #include "dlttableview.h"
 
 DltTableView::DltTableView(QWidget *parent) :
     QTableView(parent)
 {
+    firstVisibleRow = -1;
+    lastVisibleRow = -1;
+    resetPaintStatistics();
 }
 
 /*!
@@ -12,8 +17,27 @@ void DltTableView::paintEvent(QPaintEvent *event)
 {
     if(paintMutex.tryLock())
     {
+        QElapsedTimer timer;
+        timer.start();
         QTableView::paintEvent(event);
+        qint64 elapsed = timer.nsecsElapsed();
         paintMutex.unlock();
+
+        paintedViewports++;
+        paintTime += elapsed;
+        maxPaintTime = qMax(maxPaintTime, elapsed);
+
+        // the model can prepare the rows around the painted rows
+        int first = rowAt(0);
+        int last = rowAt(viewport()->height() - 1);
+        if(first >= 0 && last < 0 && model())
+            last = model()->rowCount() - 1;
+        if(first != firstVisibleRow || last != lastVisibleRow)
+        {
+            firstVisibleRow = first;
+            lastVisibleRow = last;
+            emit visibleRowsChanged(first, last);
+        }
     }
 }
 
@@ -26,3 +50,18 @@ void DltTableView::unlock()
 {
     paintMutex.unlock();
 }
+
+QString DltTableView::paintStatistics() const
+{
+    return QString("Table view: %1 viewports painted, %2 us average, %3 us maximum")
+            .arg(paintedViewports)
+            .arg(paintedViewports > 0 ? paintTime / paintedViewports / 1000 : 0)
+            .arg(maxPaintTime / 1000);
+}
+
+void DltTableView::resetPaintStatistics()
+{
+    paintedViewports = 0;
+    paintTime = 0;
+    maxPaintTime = 0;
+}
@@ -17,14 +17,26 @@ public:
     explicit DltTableView(QWidget *parent = 0);
     void lock();
     void unlock();
+
+    // number of painted viewports and the time needed to paint them
+    QString paintStatistics() const;
+    void resetPaintStatistics();
 private:
     QMutex paintMutex;
+    int firstVisibleRow;
+    int lastVisibleRow;
+
+    qint64 paintedViewports;
+    qint64 paintTime;
+    qint64 maxPaintTime;
 
 protected:
     void paintEvent(QPaintEvent *e);
 
 signals:
-    
+    // the rows shown in the viewport changed, -1 if no row is shown
+    void visibleRowsChanged(int first, int last);
+
 public slots:
     
 };
@@ -94,6 +94,7 @@ MainWindow::MainWindow(QWidget *parent) :
     isSearchOngoing(false)
 {
     dltIndexer = NULL;
+    htmlDelegate = NULL;
     settings = QDltSettingsManager::getInstance();
     ui->setupUi(this);
     ui->enableConfigFrame->setVisible(false);
@@ -315,6 +316,7 @@ void MainWindow::initState()
     project.ecu = ui->configWidget;
     project.filter = ui->filterWidget;
     project.plugin = ui->pluginWidget;
+    project.descriptions.setTree(project.ecu);
 
     connect(ui->pluginWidget, SIGNAL(pluginOrderChanged(QString, int)), this, SLOT(on_pluginWidget_pluginPriorityChanged(QString, int)));
 
@@ -359,11 +361,10 @@ void MainWindow::initView()
 
     /* set table size and en */
     ui->tableView->setModel(tableModel);
+    connect(ui->tableView, SIGNAL(visibleRowsChanged(int,int)), tableModel, SLOT(prefetchRows(int,int)));
 
-    /* For future use enable HTML View in Table */
-    //HtmlDelegate* delegate = new HtmlDelegate();
-    //ui->tableView->setItemDelegate(delegate);
-    //ui->tableView->setItemDelegateForColumn(FieldNames::Payload,delegate);
+    /* the HTML View is installed by applySettings() when enabled */
+    defaultDelegate = ui->tableView->itemDelegate();
 
     /* preset the witdth of the columns somwhow */
     for  (int col=0;col <= ui->tableView->model()->columnCount();col++)
@@ -600,15 +601,15 @@ void MainWindow::initFileHandling()
     connect(dltIndexer, SIGNAL(started()), this, SLOT(indexStart()));
 
     /* Plugins/Filters enabled checkboxes */
-    pluginsEnabled = QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool();
+    pluginsEnabled = QDltSettingsManager::getInstance()->snapshot()->pluginsEnabled();
     dltIndexer->setPluginsEnabled(pluginsEnabled);
     ui->pluginsEnabled->setChecked(pluginsEnabled);
 
-    ui->filtersEnabled->setChecked(QDltSettingsManager::getInstance()->value("startup/filtersEnabled", true).toBool());
+    ui->filtersEnabled->setChecked(QDltSettingsManager::getInstance()->snapshot()->filtersEnabled());
     ui->checkBoxSortByTime->setEnabled(ui->filtersEnabled->isChecked());
-    ui->checkBoxSortByTime->setChecked(QDltSettingsManager::getInstance()->value("startup/sortByTimeEnabled", false).toBool());
+    ui->checkBoxSortByTime->setChecked(QDltSettingsManager::getInstance()->snapshot()->sortByTimeEnabled());
     ui->checkBoxSortByTimestamp->setEnabled(ui->filtersEnabled->isChecked());
-    ui->checkBoxSortByTimestamp->setChecked(QDltSettingsManager::getInstance()->value("startup/sortByTimestampEnabled", false).toBool());
+    ui->checkBoxSortByTimestamp->setChecked(QDltSettingsManager::getInstance()->snapshot()->sortByTimestampEnabled());
 
     /* Process Project */
     if(QDltOptManager::getInstance()->isProjectFile())
@@ -1811,9 +1812,9 @@ void MainWindow::reloadLogFileFinishFilter()
     }
 
     // enable filter if requested
-    qfile.enableFilter(QDltSettingsManager::getInstance()->value("startup/filtersEnabled", true).toBool());
-    qfile.enableSortByTime(QDltSettingsManager::getInstance()->value("startup/sortByTimeEnabled", false).toBool());
-    qfile.enableSortByTimestamp(QDltSettingsManager::getInstance()->value("startup/sortByTimestampEnabled", false).toBool());
+    qfile.enableFilter(QDltSettingsManager::getInstance()->snapshot()->filtersEnabled());
+    qfile.enableSortByTime(QDltSettingsManager::getInstance()->snapshot()->sortByTimeEnabled());
+    qfile.enableSortByTimestamp(QDltSettingsManager::getInstance()->snapshot()->sortByTimestampEnabled());
 
     // updateIndex, if messages are received in between
     updateIndex();
@@ -1881,7 +1882,7 @@ void MainWindow::reloadLogFile(bool update, bool multithreaded)
     // update indexFilter only if index already generated
     if( true == update )
     {
-        if(QDltSettingsManager::getInstance()->value("startup/filtersEnabled", true).toBool())
+        if(QDltSettingsManager::getInstance()->snapshot()->filtersEnabled())
         {
             //qDebug() << "indexer with filter" << __LINE__;
             dltIndexer->setMode(DltFileIndexer::modeFilter);
@@ -1914,6 +1915,9 @@ void MainWindow::reloadLogFile(bool update, bool multithreaded)
     tableModel->setForceEmpty(true);
     tableModel->modelChanged();
 
+    // decoded rows belong to the old file, prefetching is stopped before the file is opened again
+    tableModel->clearRowCache();
+
     // stop last indexing process, if any
     dltIndexer->stop();
 
@@ -1954,13 +1958,14 @@ void MainWindow::reloadLogFile(bool update, bool multithreaded)
     statusFilename->setToolTip(name);
 
     // enable plugins
-    pluginsEnabled = QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool();
+    pluginsEnabled = QDltSettingsManager::getInstance()->snapshot()->pluginsEnabled();
     dltIndexer->setPluginsEnabled(pluginsEnabled);
-    dltIndexer->setFiltersEnabled(QDltSettingsManager::getInstance()->value("startup/filtersEnabled", true).toBool());
-    dltIndexer->setSortByTimeEnabled(QDltSettingsManager::getInstance()->value("startup/sortByTimeEnabled", false).toBool());
-    dltIndexer->setSortByTimestampEnabled(QDltSettingsManager::getInstance()->value("startup/sortByTimestampEnabled", false).toBool());
+    dltIndexer->setFiltersEnabled(QDltSettingsManager::getInstance()->snapshot()->filtersEnabled());
+    dltIndexer->setSortByTimeEnabled(QDltSettingsManager::getInstance()->snapshot()->sortByTimeEnabled());
+    dltIndexer->setSortByTimestampEnabled(QDltSettingsManager::getInstance()->snapshot()->sortByTimestampEnabled());
     dltIndexer->setMultithreaded(multithreaded);
     dltIndexer->setFilterCacheEnabled(settings->filterCache);
+    updateStringCacheState();
 
     // run through all viewer plugins
     // must be run in the UI thread, if some gui actions are performed
@@ -2005,11 +2010,11 @@ void MainWindow::reloadLogFileDefaultFilter()
     statusProgressBar->show();
 
     // enable plugins
-    pluginsEnabled = QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool();
+    pluginsEnabled = QDltSettingsManager::getInstance()->snapshot()->pluginsEnabled();
     dltIndexer->setPluginsEnabled(pluginsEnabled);
-    dltIndexer->setFiltersEnabled(QDltSettingsManager::getInstance()->value("startup/filtersEnabled", true).toBool());
-    dltIndexer->setSortByTimeEnabled(QDltSettingsManager::getInstance()->value("startup/sortByTimeEnabled", false).toBool());
-    dltIndexer->setSortByTimestampEnabled(QDltSettingsManager::getInstance()->value("startup/sortByTimestampEnabled", false).toBool());
+    dltIndexer->setFiltersEnabled(QDltSettingsManager::getInstance()->snapshot()->filtersEnabled());
+    dltIndexer->setSortByTimeEnabled(QDltSettingsManager::getInstance()->snapshot()->sortByTimeEnabled());
+    dltIndexer->setSortByTimestampEnabled(QDltSettingsManager::getInstance()->snapshot()->sortByTimestampEnabled());
 
     // start indexing
     dltIndexer->start();
@@ -2061,6 +2066,64 @@ void MainWindow::applySettings()
     // disable or enable filter cache
     if(dltIndexer)
         dltIndexer->setFilterCacheEnabled(settings->filterCache);
+
+    updateStringCacheState();
+    updateHtmlDelegate();
+}
+
+void MainWindow::updateHtmlDelegate()
+{
+    if((htmlDelegate != NULL) == (settings->htmlView != 0))
+        return;
+
+    // compare the paint time with and without the html delegate
+    qDebug().noquote() << ui->tableView->paintStatistics();
+    ui->tableView->resetPaintStatistics();
+
+    if(settings->htmlView)
+    {
+        htmlDelegate = new HtmlDelegate(ui->tableView);
+        ui->tableView->setItemDelegate(htmlDelegate);
+    }
+    else
+    {
+        ui->tableView->setItemDelegate(defaultDelegate);
+        qDebug().noquote() << htmlDelegate->statistics();
+        delete htmlDelegate;
+        htmlDelegate = NULL;
+    }
+    ui->tableView->viewport()->update();
+}
+
+void MainWindow::updateStringCacheState()
+{
+    quint64 state = pluginsEnabled ? 1 : 0;
+
+    // the order of the decoder plugins changes the decoded strings too
+    if(pluginsEnabled)
+    {
+        QList<QDltPlugin*> plugins = pluginManager.getDecoderPlugins();
+        for(int num = 0; num < plugins.size(); num++)
+        {
+            QDltPlugin *plugin = plugins[num];
+            state = state * 31 + qHash(plugin->getName());
+            state = state * 31 + (quint64) plugin->getMode();
+            state = state * 31 + qHash(plugin->getFilename());
+        }
+    }
+
+    state = state * 31 + (quint64) settings->automaticTimeSettings;
+    state = state * 31 + (quint64) settings->utcOffset;
+    state = state * 31 + (quint64) settings->dst;
+
+    // the marks and the rows of the table are created from the decoded messages too
+    if(state != qfile.getStringCache()->getState())
+    {
+        qfile.clearMsgMarks();
+        tableModel->clearRowCache();
+    }
+
+    qfile.getStringCache()->setState(state);
 }
 
 
@@ -2169,7 +2232,7 @@ void MainWindow::on_action_menuProject_Open_triggered()
 
 bool MainWindow::anyFiltersEnabled()
 {
-    if(!(QDltSettingsManager::getInstance()->value("startup/filtersEnabled", true).toBool()))
+    if(!(QDltSettingsManager::getInstance()->snapshot()->filtersEnabled()))
     {
         return false;
     }
@@ -2230,7 +2293,7 @@ bool MainWindow::openDlpFile(QString fileName)
         on_filterWidget_itemSelectionChanged();
 
         /* Finally, enable the 'Apply' button, if needed */
-        if((QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool()) || anyFiltersEnabled())
+        if((QDltSettingsManager::getInstance()->snapshot()->pluginsEnabled()) || anyFiltersEnabled())
         {
             applyConfigEnabled(true);
         }
@@ -3907,6 +3970,9 @@ void MainWindow::updateIndex()
     /* read received messages in DLT file parser and update DLT message list view */
     /* update indexes  and table view */
     int oldsize = qfile.size();
+
+    /* the rows are not prefetched, while the index is updated and the plugins are called for the new messages */
+    tableModel->lockRowCache();
     qfile.updateIndex();
 
     bool silentMode = !QDltOptManager::getInstance()->issilentMode();
@@ -3967,6 +4033,7 @@ void MainWindow::updateIndex()
         }
     }
 
+    tableModel->unlockRowCache();
 }
 
 void MainWindow::draw_timeout()
@@ -3982,7 +4049,8 @@ void MainWindow::drawUpdatedView()
     statusBytesReceived->setText(QString("Recv: %L1").arg(totalBytesRcvd));
     statusSyncFoundReceived->setText(QString("Sync found: %L1").arg(totalSyncFoundRcvd));
 
-    tableModel->modelChanged();
+    /* messages received since the last update are inserted, the other rows are not queried again */
+    tableModel->updateRows();
 
     //Line below would resize the payload column automatically so that the whole content is readable
     //ui->tableView->resizeColumnToContents(11); //Column 11 is the payload column
@@ -4039,7 +4107,8 @@ void MainWindow::onTableViewSelectionChanged(const QItemSelection & selected, co
             return;
         }
 
-        // Update plugins
+        // Update plugins, the rows are not prefetched while the plugins are called
+        tableModel->lockRowCache();
         for(int i = 0; i < activeViewerPlugins.size() ; i++)
         {
             item = (QDltPlugin*)activeViewerPlugins.at(i);
@@ -4056,6 +4125,7 @@ void MainWindow::onTableViewSelectionChanged(const QItemSelection & selected, co
             item = (QDltPlugin*)activeViewerPlugins.at(i);
             item->selectedIdxMsgDecoded(msgIndex,msg);
         }
+        tableModel->unlockRowCache();
     }
 }
 
@@ -6037,6 +6107,12 @@ void MainWindow::updatePlugin(PluginItem *item)
 
     item->update(); //update the table view in plugin tab
 
+    // the reloaded configuration can change the decoded strings, even if the configuration file name is the same
+    qfile.getStringCache()->clear();
+    qfile.clearMsgMarks();
+    tableModel->clearRowCache();
+    updateStringCacheState();
+
     if(item->dockWidget)
     {
         if(item->getMode() == QDltPlugin::ModeShow)
@@ -7295,14 +7371,14 @@ int MainWindow::nearest_line(int line)
          * for the last one that we saw before going over */
         int lastFound = 0;
 
-        QVector<qint64> filterIndices = qfile.getIndexFilter();
+        const QDltIndex &filterIndices = qfile.getIndexFilter();
 
         if(!filterIndices.isEmpty())
         {
             lastFound = filterIndices.indexOf(line);
             if(lastFound < 0)
             {
-                QVector<qint64> sortedIndices = filterIndices;
+                QVector<qint64> sortedIndices = filterIndices.toVector();
                 qSort(sortedIndices);
 
                 int lastIndex = sortedIndices[0];
@@ -132,6 +132,10 @@ private:
     bool outputfileIsFromCLI;
     TableModel *tableModel;
     SearchTableModel *m_searchtableModel;
+
+    /* Delegate showing cells with html markup, only installed in the table when enabled in the settings */
+    HtmlDelegate *htmlDelegate;
+    QAbstractItemDelegate *defaultDelegate;
     WorkingDirectory workingDirectory;
 
     /* Status line items */
@@ -262,6 +266,18 @@ private:
 
     void reloadLogFileDefaultFilter();
 
+    /**
+        * @brief Update the state of the rendered header and payload strings
+        * The strings are removed from the cache when decoder plugins or time settings changed.
+        */
+    void updateStringCacheState();
+
+    /**
+        * @brief Install or remove the html delegate of the table
+        * The paint time of the table is logged each time the delegate is switched.
+        */
+    void updateHtmlDelegate();
+
     void exportSelection(bool ascii,bool file,bool payload_only);
     void exportSelection_searchTable(bool payload_only);
 
@@ -22,6 +22,7 @@
 
 #include "qdlt.h"
 #include "plugintreewidget.h"
+#include "dltdescriptionindex.h"
 
 
 #include <QTreeWidget>
@@ -305,6 +306,9 @@ public:
     //SettingsDialog *settings;
     QDltSettingsManager *settings;
 
+    /* descriptions of the applications and contexts in the ECU tree */
+    DltDescriptionIndex descriptions;
+
 private:
 
 
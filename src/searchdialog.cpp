@@ -420,8 +420,13 @@ void SearchDialog::findMessages(long int searchLine, long int searchBorder, QReg
     fileprogress.setWindowModality(Qt::NonModal);
     fileprogress.show();
 
-    bool msgIdEnabled=QDltSettingsManager::getInstance()->value("startup/showMsgId", true).toBool();
-    QString msgIdFormat=QDltSettingsManager::getInstance()->value("startup/msgIdFormat", "0x%x").toString();
+    bool msgIdEnabled=QDltSettingsManager::getInstance()->snapshot()->showMsgId();
+    QString msgIdFormat=QDltSettingsManager::getInstance()->snapshot()->msgIdFormat();
+    bool pluginsEnabled=QDltSettingsManager::getInstance()->snapshot()->pluginsEnabled();
+
+    // header and payload strings are shared with the message table
+    QDltStringCache *stringCache = file->getStringCache();
+    qint64 msgIndex;
 
     do
     {
@@ -459,10 +464,21 @@ void SearchDialog::findMessages(long int searchLine, long int searchBorder, QReg
 
         /* get the message with the selected item id */
         buf = file->getMsgFilter(searchLine);
+        msgIndex = file->getMsgFilterPos(searchLine);
+
+        /* check APID and CTID in the header before the message is parsed,
+           decoder plugins may change them, so the check is done after decoding if plugins are enabled */
+        if ( true == fIs_APID_CTID_requested && false == pluginsEnabled )
+        {
+            QDltMsgView view(buf);
+            if ( false == matchApidCtid(QDltMsgView::idToString(view.getApid()), QDltMsgView::idToString(view.getCtid()), is_Case_Sensitive) )
+                continue; // because if APID or CTID  doesn not fit there is no need to search in any payload or header
+        }
+
         msg.setMsg(buf);
 
         /* decode the message if desired - could this call be avoided as the message is already decoded elsewhere ? */
-        if(QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool())
+        if(pluginsEnabled)
         {
             //qDebug() << "Decode" << __LINE__;
             pluginManager->decodeMsg(msg, fSilentMode);
@@ -473,35 +489,22 @@ void SearchDialog::findMessages(long int searchLine, long int searchBorder, QReg
         /* search header */
         if( text.isEmpty() )
         {
-            text += msg.toStringHeader();
+            text += stringCache->header(msgIndex, msg);
             if ( msgIdEnabled==true )
             {
                 text += " "+QString().sprintf(msgIdFormat.toLatin1(),msg.getMessageId());
             }
-            tempPayLoad = msg.toStringPayload();
+            tempPayLoad = stringCache->payload(msgIndex, msg);
 
         } // get the header text in case not empty
         headerText = text;
-        if ( true == fIs_APID_CTID_requested )
+        if ( true == fIs_APID_CTID_requested && true == pluginsEnabled )
             {
               QString APID = headerText.section(" ",5,5);
               QString CTID = headerText.section(" ",6,6);
               // and check if the condition is valid
-              if ( ( APID.compare(stApid,is_Case_Sensitive) == 0 ) && ( stCtid.size() == 0 ) )
-              {
-                 // qDebug() << "APID hit" << searchLine << __LINE__;
-              }
-              else if ( ( CTID.compare(stCtid,is_Case_Sensitive) == 0 ) && ( stApid.size() == 0 ) )
-              {
-                 // qDebug() << "CTID hit" << searchLine << __LINE__;
-              }
-              else if( ( CTID.compare(stCtid,is_Case_Sensitive) == 0) && ( APID.compare(stApid,is_Case_Sensitive) == 0 ) )
-              {
-                 // qDebug() << "CTID & APID hit" << searchLine << __LINE__;
-              }
-              else
+              if ( false == matchApidCtid(APID, CTID, is_Case_Sensitive) )
               {
-                 //qDebug() << APID << CTID << searchLine;
                  continue; // because if APID or CTID  doesn not fit there is no need to search in any payload or header
               }
             }
@@ -582,7 +585,7 @@ void SearchDialog::findMessages(long int searchLine, long int searchBorder, QReg
 
             if( text.isEmpty())
             {
-                text += msg.toStringPayload();
+                text += stringCache->payload(msgIndex, msg);
             }
 
             if (getRegExp() == true)
@@ -743,6 +746,24 @@ bool SearchDialog::timeStampPayloadValidityCheck(long int searchLine)
 }
 
 
+bool SearchDialog::matchApidCtid(const QString &apid, const QString &ctid, Qt::CaseSensitivity cs) const
+{
+    if ( ( apid.compare(stApid,cs) == 0 ) && ( stCtid.size() == 0 ) )
+    {
+        return true; // APID hit
+    }
+    else if ( ( ctid.compare(stCtid,cs) == 0 ) && ( stApid.size() == 0 ) )
+    {
+        return true; // CTID hit
+    }
+    else if( ( ctid.compare(stCtid,cs) == 0) && ( apid.compare(stApid,cs) == 0 ) )
+    {
+        return true; // CTID & APID hit
+    }
+
+    return false;
+}
+
 bool SearchDialog::foundLine(long int searchLine)
 {
     match = true;
@@ -134,6 +134,7 @@ private:
     bool getOnceClicked();
     bool searchtoIndex();
     bool foundLine(long int searchLine);
+    bool matchApidCtid(const QString &apid, const QString &ctid, Qt::CaseSensitivity cs) const;
     bool payLoadValidityCheck();
     bool payLoadStartpatternCheck();
     bool payLoadStoppatternCheck();
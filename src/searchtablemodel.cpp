@@ -65,7 +65,7 @@ QVariant SearchTableModel::data(const QModelIndex &index, int role) const
             return QVariant();
         }
 
-        if(QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool())
+        if(QDltSettingsManager::getInstance()->snapshot()->pluginsEnabled())
             pluginManager->decodeMsg(msg,!QDltOptManager::getInstance()->issilentMode());
 
         QString visu_data;
@@ -76,9 +76,9 @@ QVariant SearchTableModel::data(const QModelIndex &index, int role) const
             return QString("%L1").arg((m_searchResultList.at(index.row())));
         case FieldNames::Time:
             if( project->settings->automaticTimeSettings == 0 )
-               return QString("%1.%2").arg(msg.getGmTimeWithOffsetString(project->settings->utcOffset,project->settings->dst)).arg(msg.getMicroseconds(),6,10,QLatin1Char('0'));
+               return QDltTimeFormatter::threadInstance().gmTimeWithOffset(msg.getTime(),msg.getMicroseconds(),project->settings->utcOffset,project->settings->dst);
             else
-               return QString("%1.%2").arg(msg.getTimeString()).arg(msg.getMicroseconds(),6,10,QLatin1Char('0'));
+               return QDltTimeFormatter::threadInstance().localTime(msg.getTime(),msg.getMicroseconds());
         case FieldNames::TimeStamp:
             return QString("%1.%2").arg(msg.getTimestamp()/10000).arg(msg.getTimestamp()%10000,4,10,QLatin1Char('0'));
         case FieldNames::Counter:
@@ -91,19 +91,12 @@ QVariant SearchTableModel::data(const QModelIndex &index, int role) const
                 return msg.getApid();
                 break;
             case 1:
-                  for(int num = 0; num < project->ecu->topLevelItemCount (); num++)
-                   {
-                    EcuItem *ecuitem = (EcuItem*)project->ecu->topLevelItem(num);
-                    for(int numapp = 0; numapp < ecuitem->childCount(); numapp++)
-                    {
-                        ApplicationItem * appitem = (ApplicationItem *) ecuitem->child(numapp);
-                        if(appitem->id == msg.getApid() && !appitem->description.isEmpty())
-                        {
-                           return appitem->description;
-                        }
-                    }
-                   }
-                  return QString("Apid: %1 (No description)").arg(msg.getApid());
+            {
+                QString description = project->descriptions.application(msg.getApid());
+                if(!description.isEmpty())
+                    return description;
+                return QString("Apid: %1 (No description)").arg(msg.getApid());
+            }
                 break;
              default:
                 return msg.getApid();
@@ -114,26 +107,12 @@ QVariant SearchTableModel::data(const QModelIndex &index, int role) const
                 return msg.getCtid();
                 break;
             case 1:
-
-                  for(int num = 0; num < project->ecu->topLevelItemCount (); num++)
-                   {
-                    EcuItem *ecuitem = (EcuItem*)project->ecu->topLevelItem(num);
-                    for(int numapp = 0; numapp < ecuitem->childCount(); numapp++)
-                    {
-                        ApplicationItem * appitem = (ApplicationItem *) ecuitem->child(numapp);
-                        for(int numcontext = 0; numcontext < appitem->childCount(); numcontext++)
-                        {
-                            ContextItem * conitem = (ContextItem *) appitem->child(numcontext);
-
-                            if(appitem->id == msg.getApid() && conitem->id == msg.getCtid()
-                                    && !conitem->description.isEmpty())
-                            {
-                               return conitem->description;
-                            }
-                        }
-                    }
-                   }
-                  return  QString("Ctid: %1 (No description)").arg(msg.getCtid());
+            {
+                QString description = project->descriptions.context(msg.getApid(), msg.getCtid());
+                if(!description.isEmpty())
+                    return description;
+                return QString("Ctid: %1 (No description)").arg(msg.getCtid());
+            }
                 break;
              default:
                 return msg.getCtid();
@@ -162,8 +141,8 @@ QVariant SearchTableModel::data(const QModelIndex &index, int role) const
             return QString("%1").arg(msg.getNumberOfArguments());
         case FieldNames::Payload:
             /* display payload */
-            visu_data = msg.toStringPayload().trimmed();
-            if((QDltSettingsManager::getInstance()->value("startup/filtersEnabled", true).toBool()))
+            visu_data = qfile->getStringCache()->payload(m_searchResultList.at(index.row()), msg).trimmed();
+            if((QDltSettingsManager::getInstance()->snapshot()->filtersEnabled()))
             {
                 for(int num = 0; num < project->filter->topLevelItemCount (); num++) {
                     FilterItem *item = (FilterItem*)project->filter->topLevelItem(num);
@@ -192,37 +171,36 @@ QVariant SearchTableModel::data(const QModelIndex &index, int role) const
         }
     }
 
-    if ( role == Qt::ForegroundRole )
+    if ( role == Qt::ForegroundRole || role == Qt::BackgroundRole )
     {
-        if(qfile->getMsg(m_searchResultList.at(index.row()), msg))
-        {
-            /* Valid message found, calculate background color and find optimal forground color */
-            return QVariant(QBrush(DltUiUtils::optimalTextColor(getMsgBackgroundColor(msg))));
-        }
-        /* default return black forground color */
-        QColor brushColor = QColor(0,0,0);
-
-        if (QDltSettingsManager::UI_Colour::UI_Dark == QDltSettingsManager::getInstance()->uiColour)
+        /* the mark is stored when the message was filtered or painted before */
+        quint16 mark = qfile->getMsgMark(m_searchResultList.at(index.row()));
+        if(mark == 0 && qfile->getMsg(m_searchResultList.at(index.row()), msg))
         {
-            brushColor = QColor(255,255,255);
+            /* the stored marks are created from decoded messages */
+            if(QDltSettingsManager::getInstance()->snapshot()->pluginsEnabled())
+                pluginManager->decodeMsg(msg,!QDltOptManager::getInstance()->issilentMode());
+            mark = qfile->checkMsgMark(msg, m_searchResultList.at(index.row()));
         }
 
-        return QVariant(QBrush(brushColor));
-    }
-
-    if ( role == Qt::BackgroundRole )
-    {
-        if(qfile->getMsg(m_searchResultList.at(index.row()), msg))
+        if(mark != 0)
         {
             /* Valid message found, calculate background color */
-            return QVariant(QBrush(getMsgBackgroundColor(msg)));
+            QColor color = getMsgBackgroundColor(mark);
+            if ( role == Qt::ForegroundRole )
+            {
+                /* find optimal forground color */
+                return QVariant(QBrush(DltUiUtils::optimalTextColor(color)));
+            }
+            return QVariant(QBrush(color));
         }
-        /* default return white background color */
-        QColor brushColor = QColor(255,255,255);
+
+        /* default return black forground color and white background color */
+        QColor brushColor = (role == Qt::ForegroundRole) ? QColor(0,0,0) : QColor(255,255,255);
 
         if (QDltSettingsManager::UI_Colour::UI_Dark == QDltSettingsManager::getInstance()->uiColour)
         {
-            brushColor = QColor(31,31,31);
+            brushColor = (role == Qt::ForegroundRole) ? QColor(255,255,255) : QColor(31,31,31);
         }
 
         return QVariant(QBrush(brushColor));
@@ -317,10 +295,10 @@ int SearchTableModel::get_SearchResultListSize() const
     return m_searchResultList.size();
 }
 
-QColor SearchTableModel::getMsgBackgroundColor(QDltMsg &msg) const
+QColor SearchTableModel::getMsgBackgroundColor(quint16 mark) const
 {
     /* get check marker color */
-    QColor color = qfile->checkMarker(msg);
+    QColor color = qfile->getMsgMarkColor(mark);
     if(color.isValid())
     {
         /* Valid marker found, use background color as defined in marker */
@@ -328,18 +306,17 @@ QColor SearchTableModel::getMsgBackgroundColor(QDltMsg &msg) const
     }
     else
     {
-        if(project->settings->autoMarkFatalError && ( msg.getSubtypeString() == "error" || msg.getSubtypeString() == "fatal") )
+        if(project->settings->autoMarkFatalError && (mark & QDltFile::DltMsgMarkError))
         {
            /* If automark error is enabled, set red as background color */
            return QColor(255,0,0);
         }
-        if(project->settings->autoMarkWarn && msg.getSubtypeString() == "warn")
+        if(project->settings->autoMarkWarn && (mark & QDltFile::DltMsgMarkWarn))
         {
             /* If automark warning is enabled, set red as background color */
            return QColor(255,255,0);
         }
-        if(project->settings->autoMarkMarker && msg.getType()==QDltMsg::DltTypeControl &&
-           msg.getSubtype()==QDltMsg::DltControlResponse && msg.getCtrlServiceId() == DLT_SERVICE_ID_MARKER)
+        if(project->settings->autoMarkMarker && (mark & QDltFile::DltMsgMarkControl))
         {
             /* If automark marker is enabled, set green as background color */
            return QColor(0,255,0);
@@ -365,6 +365,7 @@ void SettingsDialog::writeDlg()
     ui->checkBoxMode->setCheckState(settings->showMode?Qt::Checked:Qt::Unchecked);
     ui->checkBoxNoar->setCheckState(settings->showNoar?Qt::Checked:Qt::Unchecked);
     ui->checkBoxPayload->setCheckState(settings->showPayload?Qt::Checked:Qt::Unchecked);
+    ui->checkBoxHtmlView->setCheckState(settings->htmlView?Qt::Checked:Qt::Unchecked);
     ui->groupBoxMessageId->setChecked(settings->showMsgId?Qt::Checked:Qt::Unchecked);
     ui->spinBox_showArguments->setValue(settings->showArguments);
 
@@ -452,6 +453,7 @@ void SettingsDialog::readDlg()
     settings->showMode = ( ui->checkBoxMode->checkState() == Qt::Checked);
     settings->showNoar = ( ui->checkBoxNoar->checkState() == Qt::Checked);
     settings->showPayload = ( ui->checkBoxPayload->checkState() == Qt::Checked);
+    settings->htmlView = ( ui->checkBoxHtmlView->checkState() == Qt::Checked);
     settings->showArguments = (ui->spinBox_showArguments->value());
     settings->showMsgId     = (ui->groupBoxMessageId->isChecked()==true?1:0);
 
@@ -148,8 +148,13 @@ SOURCES += main.cpp \
     plugintreewidget.cpp \
     exporterdialog.cpp \
     dltmsgqueue.cpp \
+    dltmsgpool.cpp \
+    dltrowcache.cpp \
+    dltfilterbitmap.cpp \
+    dltdescriptionindex.cpp \
     dltfileindexerthread.cpp \
     dltfileindexerdefaultfilterthread.cpp \
+    dltfileindexersort.cpp \
     mcudpsocket.cpp \
     dltmessagefinder.cpp \
 
@@ -183,8 +188,13 @@ HEADERS += mainwindow.h \
     plugintreewidget.h \
     exporterdialog.h \
     dltmsgqueue.h \
+    dltmsgpool.h \
+    dltrowcache.h \
+    dltfilterbitmap.h \
+    dltdescriptionindex.h \
     dltfileindexerthread.h \
     dltfileindexerdefaultfilterthread.h \
+    dltfileindexersort.h \
     mcudpsocket.h \
     dltmessagefinder.h \
     regex_search_replace.h
@@ -19,6 +19,7 @@
 
 #include <QtGui>
 #include <QApplication>
+#include <QElapsedTimer>
 #include <qmessagebox.h>
 
 #include "tablemodel.h"
@@ -27,33 +28,9 @@
 #include "dlt_protocol.h"
 #include "regex_search_replace.h"
 
-static long int lastrow = -1; // necessary because object tablemodel can not be changed, so no member variable can be used
 char buffer[DLT_VIEWER_LIST_BUFFER_SIZE];
 
 
-void getmessage( int indexrow, long int filterposindex, unsigned int* decodeflag, QDltMsg* msg, QDltMsg* lastmsg, QDltFile* qfile, bool* success )
-{
- if ( indexrow == lastrow)
- {
-  *msg = *lastmsg;
- }
- else
- {
-  *success = qfile->getMsg(filterposindex, *msg);
-  *lastmsg = *msg;
-  *decodeflag = 1;
- }
- if ( indexrow == 0)
- {
-  lastrow = 0;
- }
- else
- {
-  lastrow = indexrow;
- }
-}
-
-
 TableModel::TableModel(const QString & /*data*/, QObject *parent)
      : QAbstractTableModel(parent)
  {
@@ -64,12 +41,14 @@ TableModel::TableModel(const QString & /*data*/, QObject *parent)
      emptyForceFlag = false;
      loggingOnlyMode = false;
      searchhit = -1;
-     lastrow = -1;
+     firstVisibleRow = -1;
+     lastVisibleRow = -1;
+     reportedRowCount = 0;
  }
 
  TableModel::~TableModel()
  {
-
+     qDebug().noquote() << rowCache.statistics();
  }
 
 
@@ -81,12 +60,8 @@ TableModel::TableModel(const QString & /*data*/, QObject *parent)
 
  QVariant TableModel::data(const QModelIndex &index, int role) const
  {
-     QByteArray buf;
-     static QDltMsg msg;
-     static QDltMsg lastmsg;
-     static QDltMsg last_decoded_msg;
-     static unsigned int decodeflag = 0;
-     static bool success = true;
+     static const QSharedPointer<const DltRowCacheEntry> emptyRow(new DltRowCacheEntry());
+     QSharedPointer<const DltRowCacheEntry> row;
 
      long int filterposindex = 0;
 
@@ -105,16 +80,16 @@ TableModel::TableModel(const QString & /*data*/, QObject *parent)
 
      if (role == Qt::DisplayRole)
      {
-         /* get the message with the selected item id */
+         /* get the decoded message with the selected item id */
          if(true == loggingOnlyMode)
          {
-             msg = QDltMsg();
+             row = emptyRow;
          }
          else
          {
-           getmessage( index.row(), filterposindex, &decodeflag, &msg, &lastmsg, qfile, &success);
+           row = rowCache.row(qfile, pluginManager, filterposindex, QDltSettingsManager::getInstance()->snapshot()->pluginsEnabled());
 
-           if ( success == false )
+           if ( row->valid == false )
            {
              if(index.column() == FieldNames::Index)
              {
@@ -129,21 +104,7 @@ TableModel::TableModel(const QString & /*data*/, QObject *parent)
           }
          }
 
-         if((QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool()))
-         {
-             if ( decodeflag == 1 )
-              {
-               decodeflag = 0;
-               last_decoded_msg = msg;
-               pluginManager->decodeMsg(msg,!QDltOptManager::getInstance()->issilentMode());
-               last_decoded_msg = msg;
-              }
-              else
-              {
-                msg = last_decoded_msg;
-              }
-         }
-
+         const QDltMsg &msg = row->msg;
          QString visu_data;
          switch(index.column())
          {
@@ -152,9 +113,9 @@ TableModel::TableModel(const QString & /*data*/, QObject *parent)
              return QString("%L1").arg(qfile->getMsgFilterPos(index.row()));
          case FieldNames::Time:
              if( project->settings->automaticTimeSettings == 0 )
-                return QString("%1.%2").arg(msg.getGmTimeWithOffsetString(project->settings->utcOffset,project->settings->dst)).arg(msg.getMicroseconds(),6,10,QLatin1Char('0'));
+                return QDltTimeFormatter::threadInstance().gmTimeWithOffset(msg.getTime(),msg.getMicroseconds(),project->settings->utcOffset,project->settings->dst);
              else
-                return QString("%1.%2").arg(msg.getTimeString()).arg(msg.getMicroseconds(),6,10,QLatin1Char('0'));
+                return QDltTimeFormatter::threadInstance().localTime(msg.getTime(),msg.getMicroseconds());
          case FieldNames::TimeStamp:
              return QString("%1.%2").arg(msg.getTimestamp()/10000).arg(msg.getTimestamp()%10000,4,10,QLatin1Char('0'));
          case FieldNames::Counter:
@@ -168,19 +129,12 @@ TableModel::TableModel(const QString & /*data*/, QObject *parent)
                  return msg.getApid();
                  break;
              case 1:
-                   for(int num = 0; num < project->ecu->topLevelItemCount (); num++)
-                    {
-                     EcuItem *ecuitem = (EcuItem*)project->ecu->topLevelItem(num);
-                     for(int numapp = 0; numapp < ecuitem->childCount(); numapp++)
-                     {
-                         ApplicationItem * appitem = (ApplicationItem *) ecuitem->child(numapp);
-                         if(appitem->id == msg.getApid() && !appitem->description.isEmpty())
-                         {
-                            return appitem->description;
-                         }
-                     }
-                    }
-                   return QString("Apid: %1 (No description)").arg(msg.getApid());
+             {
+                 QString description = project->descriptions.application(msg.getApid());
+                 if(!description.isEmpty())
+                     return description;
+                 return QString("Apid: %1 (No description)").arg(msg.getApid());
+             }
                  break;
               default:
                  return msg.getApid();
@@ -192,25 +146,12 @@ TableModel::TableModel(const QString & /*data*/, QObject *parent)
                  return msg.getCtid();
                  break;
              case 1:
-                   for(int num = 0; num < project->ecu->topLevelItemCount (); num++)
-                    {
-                     EcuItem *ecuitem = (EcuItem*)project->ecu->topLevelItem(num);
-                     for(int numapp = 0; numapp < ecuitem->childCount(); numapp++)
-                     {
-                         ApplicationItem * appitem = (ApplicationItem *) ecuitem->child(numapp);
-                         for(int numcontext = 0; numcontext < appitem->childCount(); numcontext++)
-                         {
-                             ContextItem * conitem = (ContextItem *) appitem->child(numcontext);
-
-                             if(appitem->id == msg.getApid() && conitem->id == msg.getCtid()
-                                     && !conitem->description.isEmpty())
-                             {
-                                return conitem->description;
-                             }
-                         }
-                     }
-                    }
-                   return  QString("Ctid: %1 (No description)").arg(msg.getCtid());
+             {
+                 QString description = project->descriptions.context(msg.getApid(), msg.getCtid());
+                 if(!description.isEmpty())
+                     return description;
+                 return QString("Ctid: %1 (No description)").arg(msg.getCtid());
+             }
                  break;
               default:
                  return msg.getCtid();
@@ -246,10 +187,10 @@ TableModel::TableModel(const QString & /*data*/, QObject *parent)
              {
                  return QString("Logging only Mode! Disable in Project Settings!");
              }
-             /* display payload */
-             visu_data = msg.toStringPayload().trimmed().replace('\n', ' ');
+             /* display payload, rendered when the row was decoded */
+             visu_data = row->payload;
 
-             if((QDltSettingsManager::getInstance()->value("startup/filtersEnabled", true).toBool()))
+             if((QDltSettingsManager::getInstance()->snapshot()->filtersEnabled()))
              {
                  for(int num = 0; num < project->filter->topLevelItemCount (); num++) {
                      FilterItem *item = (FilterItem*)project->filter->topLevelItem(num);
@@ -280,54 +221,28 @@ TableModel::TableModel(const QString & /*data*/, QObject *parent)
          }
      }
 
-     if ( role == Qt::ForegroundRole )
+     if ( role == Qt::ForegroundRole || role == Qt::BackgroundRole )
      {
-         /* get message at current row */
-         getmessage( index.row(), filterposindex, &decodeflag, &msg, &lastmsg, qfile, &success); // version2
-
-         /* decode message if not already decoded */
-         if((QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool()))
+         /* the mark is stored when the message was filtered or painted before */
+         quint16 mark = qfile->getMsgMark(filterposindex);
+         if(mark == 0)
          {
-             if ( decodeflag == 1 )
-              {
-               decodeflag = 0;
-               last_decoded_msg = msg;
-               pluginManager->decodeMsg(msg,!QDltOptManager::getInstance()->issilentMode());
-               last_decoded_msg = msg;
-              }
-              else
-              {
-                msg = last_decoded_msg;
-              }
-         }
-
-         /* Calculate background color and find optimal forground color */
-         return QVariant(QBrush(DltUiUtils::optimalTextColor(getMsgBackgroundColor(msg,index.row(),filterposindex))));
-     }
+             /* get the decoded message at current row */
+             row = rowCache.row(qfile, pluginManager, filterposindex, QDltSettingsManager::getInstance()->snapshot()->pluginsEnabled());
 
-     if ( role == Qt::BackgroundRole )
-     {
-         /* get message at current row */
-         getmessage( index.row(), filterposindex, &decodeflag, &msg, &lastmsg, qfile, &success); // version2
+             /* the markers may use the message, so the cached row is not changed */
+             QDltMsg msg = row->msg;
+             mark = qfile->checkMsgMark(msg, filterposindex);
+         }
 
-         /* decode message if not already decoded */
-         if((QDltSettingsManager::getInstance()->value("startup/pluginsEnabled", true).toBool()))
+         if ( role == Qt::ForegroundRole )
          {
-             if ( decodeflag == 1 )
-              {
-               decodeflag = 0;
-               last_decoded_msg = msg;
-               pluginManager->decodeMsg(msg,!QDltOptManager::getInstance()->issilentMode());
-               last_decoded_msg = msg;
-              }
-              else
-              {
-                msg = last_decoded_msg;
-              }
+             /* Calculate background color and find optimal forground color */
+             return QVariant(QBrush(DltUiUtils::optimalTextColor(getMsgBackgroundColor(mark,index.row(),filterposindex))));
          }
 
          /* Calculate background color */
-         return QVariant(QBrush(getMsgBackgroundColor(msg,index.row(),filterposindex)));
+         return QVariant(QBrush(getMsgBackgroundColor(mark,index.row(),filterposindex)));
      }
 
      if ( role == Qt::TextAlignmentRole )
@@ -377,7 +292,7 @@ QVariant TableModel::headerData(int section, Qt::Orientation orientation,
      else if(true == loggingOnlyMode)
          return 1;
      else
-         return qfile->sizeFilter();
+         return qMin(reportedRowCount, qfile->sizeFilter()); // rows appended later are reported by updateRows()
  }
 
  void TableModel::modelChanged()
@@ -394,14 +309,71 @@ QVariant TableModel::headerData(int section, Qt::Orientation orientation,
          index(0, 0);
          index(0, columnCount() - 1);
      }
-     lastrow = -1;
 
      /* last search index must be deleted because model changed */
      lastSearchIndex = -1;
 
+     reportedRowCount = qfile->sizeFilter();
+
      emit(layoutChanged());
  }
 
+void TableModel::updateRows()
+{
+    int rows = qfile->sizeFilter();
+
+    /* the rows were changed, not only appended */
+    if(emptyForceFlag || loggingOnlyMode || rows < reportedRowCount)
+    {
+        modelChanged();
+        return;
+    }
+
+    if(rows == reportedRowCount)
+        return;
+
+    /* only the appended rows are queried by the views */
+    beginInsertRows(QModelIndex(), reportedRowCount, rows - 1);
+    reportedRowCount = rows;
+    endInsertRows();
+}
+
+void TableModel::clearRowCache()
+{
+    rowCache.clear();
+    firstVisibleRow = -1;
+    lastVisibleRow = -1;
+}
+
+void TableModel::prefetchRows(int first, int last)
+{
+    if(first == firstVisibleRow && last == lastVisibleRow)
+        return;
+
+    firstVisibleRow = first;
+    lastVisibleRow = last;
+
+    if(emptyForceFlag || loggingOnlyMode || first < 0 || last < first)
+        return;
+
+    /* the cache keeps the visible rows and two viewports above and below */
+    int rows = last - first + 1;
+    rowCache.setMaxRows(qMax(DLT_ROW_CACHE_MIN_ROWS, rows * DLT_ROW_CACHE_VIEWPORTS));
+
+    /* the nearest rows are decoded first */
+    QVector<qint64> indexes;
+    int size = qfile->sizeFilter();
+    for(int num = 1; num <= 2 * rows; num++)
+    {
+        if(last + num < size)
+            indexes.append(qfile->getMsgFilterPos(last + num));
+        if(first - num >= 0)
+            indexes.append(qfile->getMsgFilterPos(first - num));
+    }
+
+    rowCache.prefetch(qfile, pluginManager, indexes, QDltSettingsManager::getInstance()->snapshot()->pluginsEnabled());
+}
+
 int TableModel::setManualMarker(QList<unsigned long int> selectedRows, QColor hlcolor) //used in mainwindow
 {
 manualMarkerColor = hlcolor;
@@ -418,20 +390,85 @@ int TableModel::setMarker(long int lineindex, QColor hlcolor)
 
 QColor TableModel::searchBackgroundColor() const
 {
-    QString color = QDltSettingsManager::getInstance()->value("other/searchResultColor", QString("#00AAFF")).toString();
-    QColor hlColor(color);
-    return hlColor;
+    return QDltSettingsManager::getInstance()->snapshot()->searchResultColor();
+}
+
+HtmlDelegate::HtmlDelegate(QObject *parent)
+    : QStyledItemDelegate(parent), cache(DLT_HTML_DELEGATE_CACHE_SIZE)
+{
+    paintedCells = 0;
+    plainCells = 0;
+    cacheHits = 0;
+    paintTime = 0;
+}
+
+QString HtmlDelegate::statistics() const
+{
+    return QString("Html delegate: %1 cells painted in %2 ms, %3 % plain text, %4 % cached layouts")
+            .arg(paintedCells)
+            .arg(paintTime / 1000000)
+            .arg(paintedCells > 0 ? 100.0 * plainCells / paintedCells : 0.0, 0, 'f', 1)
+            .arg(paintedCells > plainCells ? 100.0 * cacheHits / (paintedCells - plainCells) : 0.0, 0, 'f', 1);
+}
+
+void HtmlDelegate::clearCache()
+{
+    cache.clear();
+}
+
+HtmlDelegateEntry *HtmlDelegate::document(const QModelIndex &index, const QString &html) const
+{
+    /* the cached rows are invalid when the model is changed */
+    if(cachedModel != index.model())
+    {
+        if(cachedModel)
+            disconnect(cachedModel, 0, this, 0);
+        cache.clear();
+        cachedModel = index.model();
+        connect(cachedModel, SIGNAL(layoutChanged()), this, SLOT(clearCache()));
+        connect(cachedModel, SIGNAL(modelReset()), this, SLOT(clearCache()));
+        connect(cachedModel, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(clearCache()));
+        connect(cachedModel, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)), this, SLOT(clearCache()));
+    }
+
+    quint64 key = ((quint64) index.row() << 32) | (quint32) index.column();
+    HtmlDelegateEntry *entry = cache.object(key);
+    if(entry && entry->html == html)
+    {
+        cacheHits++;
+        return entry;
+    }
+
+    entry = new HtmlDelegateEntry();
+    entry->html = html;
+    entry->doc.setHtml(html);
+    cache.insert(key, entry);
+
+    return entry;
 }
 
 void HtmlDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
 {
+    QElapsedTimer timer;
+    timer.start();
+
     QStyleOptionViewItem optionV4 = option;
     initStyleOption(&optionV4, index);
 
+    paintedCells++;
+
+    /* text without markup is drawn directly, no document is needed */
+    if(!Qt::mightBeRichText(optionV4.text))
+    {
+        plainCells++;
+        QStyledItemDelegate::paint(painter, option, index);
+        paintTime += timer.nsecsElapsed();
+        return;
+    }
+
     QStyle *style = optionV4.widget? optionV4.widget->style() : QApplication::style();
 
-    QTextDocument doc;
-    doc.setHtml(optionV4.text);
+    HtmlDelegateEntry *entry = document(index, optionV4.text);
 
     /// Painting item without text
     optionV4.text = QString();
@@ -447,9 +484,10 @@ void HtmlDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
     painter->save();
     painter->translate(textRect.topLeft());
     painter->setClipRect(textRect.translated(-textRect.topLeft()));
-    doc.documentLayout()->draw(painter, ctx);
+    entry->doc.documentLayout()->draw(painter, ctx);
     painter->restore();
 
+    paintTime += timer.nsecsElapsed();
 }
 
 QSize HtmlDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
@@ -457,13 +495,23 @@ QSize HtmlDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelInd
     QStyleOptionViewItem optionV4 = option;
     initStyleOption(&optionV4, index);
 
-    QTextDocument doc;
-    doc.setHtml(optionV4.text);
-    doc.setTextWidth(optionV4.rect.width());
-    return QSize(doc.idealWidth(), doc.size().height());
+    if(!Qt::mightBeRichText(optionV4.text))
+        return QStyledItemDelegate::sizeHint(option, index);
+
+    HtmlDelegateEntry *entry = document(index, optionV4.text);
+    if(entry->sizeHintWidth != optionV4.rect.width())
+    {
+        /* the document is painted without wrapping, the width is only set for the size hint */
+        entry->doc.setTextWidth(optionV4.rect.width());
+        entry->sizeHint = QSize(entry->doc.idealWidth(), entry->doc.size().height());
+        entry->doc.setTextWidth(-1);
+        entry->sizeHintWidth = optionV4.rect.width();
+    }
+
+    return entry->sizeHint;
 }
 
-QColor TableModel::getMsgBackgroundColor(QDltMsg &msg,int index,long int filterposindex) const
+QColor TableModel::getMsgBackgroundColor(quint16 mark,int index,long int filterposindex) const
 {
     /* first check manual markers with highest priority */
     if ( selectedMarkerRows.contains(index) )
@@ -472,7 +520,7 @@ QColor TableModel::getMsgBackgroundColor(QDltMsg &msg,int index,long int filterp
     }
 
     /* get check marker color */
-    QColor color = qfile->checkMarker(msg);
+    QColor color = qfile->getMsgMarkColor(mark);
     if(color.isValid())
     {
        /* Valid marker found, use background color as defined in marker */
@@ -488,18 +536,17 @@ QColor TableModel::getMsgBackgroundColor(QDltMsg &msg,int index,long int filterp
         {
           return searchhit_higlightColor;
         }
-        if(project->settings->autoMarkFatalError && ( msg.getSubtypeString() == "error" || msg.getSubtypeString() == "fatal") )
+        if(project->settings->autoMarkFatalError && (mark & QDltFile::DltMsgMarkError))
         {
            /* If automark error is enabled, set red as background color */
            return QColor(255,0,0);
         }
-        if(project->settings->autoMarkWarn && msg.getSubtypeString() == "warn")
+        if(project->settings->autoMarkWarn && (mark & QDltFile::DltMsgMarkWarn))
         {
            /* If automark warning is enabled, set red as background color */
            return QColor(255,255,0);
         }
-        if(project->settings->autoMarkMarker && msg.getType()==QDltMsg::DltTypeControl &&
-           msg.getSubtype()==QDltMsg::DltControlResponse && msg.getCtrlServiceId() == DLT_SERVICE_ID_MARKER)
+        if(project->settings->autoMarkMarker && (mark & QDltFile::DltMsgMarkControl))
         {
             /* If automark marker is enabled, set green as background color */
            return QColor(0,255,0);
@@ -25,13 +25,20 @@
 #include <QVariant>
 #include <QMutex>
 #include <QStyledItemDelegate>
+#include <QTextDocument>
+#include <QCache>
+#include <QPointer>
 
 #include "project.h"
 #include "qdlt.h"
+#include "dltrowcache.h"
 
 #define DLT_VIEWER_LIST_BUFFER_SIZE 100024
 #define DLT_VIEWER_COLUMN_COUNT FieldNames::Arg0
 
+// number of laid out cells with markup kept by the html delegate
+#define DLT_HTML_DELEGATE_CACHE_SIZE 1024
+
 extern "C"
 {
 }
@@ -55,12 +62,25 @@ public:
     Project *project;
     QDltPluginManager *pluginManager;
     void modelChanged();
+    /* report messages appended to the file, all rows are updated if the file was changed otherwise */
+    void updateRows();
     int setMarker(long int lineindex, QColor hlcolor); //used in search functionality
     int setManualMarker(QList<unsigned long int> selectedMarkerRows, QColor hlcolor); //used in mainwindow
     void setForceEmpty(bool emptyForceFlag) { this->emptyForceFlag = emptyForceFlag; }
     void setLoggingOnlyMode(bool loggingOnlyMode) { this->loggingOnlyMode = loggingOnlyMode; }
     void setLastSearchIndex(int idx) {this->lastSearchIndex = idx;}
 
+    /* remove all decoded rows, when the file or the decoder plugins change */
+    void clearRowCache();
+
+    /* stop reading the file in the background, while the index of the file is updated */
+    void lockRowCache() { rowCache.lock(); }
+    void unlockRowCache() { rowCache.unlock(); }
+
+public slots:
+    /* decode the rows around the visible rows in the background */
+    void prefetchRows(int first, int last);
+
 private:
     long int lastSearchIndex;
     bool emptyForceFlag;
@@ -71,14 +91,59 @@ private:
     QColor searchhit_higlightColor;
     QColor manualMarkerColor;
     QList<unsigned long int> selectedMarkerRows;
-    QColor getMsgBackgroundColor(QDltMsg &msg,int index,long int filterposindex) const;
+    QColor getMsgBackgroundColor(quint16 mark,int index,long int filterposindex) const;
+
+    /* decoded rows, the view reads them several times for each cell and role */
+    mutable DltRowCache rowCache;
+    int firstVisibleRow;
+    int lastVisibleRow;
+
+    /* number of rows the views know about */
+    int reportedRowCount;
 };
 
+/* One laid out cell with markup */
+class HtmlDelegateEntry
+{
+public:
+    HtmlDelegateEntry() : sizeHintWidth(-1) {}
+
+    QString html;           // text of the cell, the entry is only used for the same text
+    QTextDocument doc;      // laid out text
+    int sizeHintWidth;      // width the size hint was calculated for
+    QSize sizeHint;
+};
+
+/* Shows cells with html markup, cells without markup are drawn as plain text.
+ * The laid out documents are cached by row and column and removed, when the model changes. */
 class HtmlDelegate : public QStyledItemDelegate
 {
+    Q_OBJECT
+public:
+    HtmlDelegate(QObject *parent = 0);
+
+    /* cells painted, time needed and use of the fast path and the cache */
+    QString statistics() const;
+
+public slots:
+    void clearCache();
+
 protected:
     void paint ( QPainter * painter, const QStyleOptionViewItem & option, const QModelIndex & index ) const;
     QSize sizeHint ( const QStyleOptionViewItem & option, const QModelIndex & index ) const;
+
+private:
+    /* laid out document of a cell, created if not cached */
+    HtmlDelegateEntry *document(const QModelIndex &index, const QString &html) const;
+
+    mutable QCache<quint64, HtmlDelegateEntry> cache;
+    mutable QPointer<const QAbstractItemModel> cachedModel;
+
+    /* paint time statistics */
+    mutable qint64 paintedCells;
+    mutable qint64 plainCells;
+    mutable qint64 cacheHits;
+    mutable qint64 paintTime;
 };
 
 #endif // TABLEMODEL_H